@@ -443,6 +443,9 @@ run_tests() {
     if [[ -x "${BUILD_DIR}/tests/test_mdbx_simple" ]]; then
         test_files+=("${BUILD_DIR}/tests/test_mdbx_simple")
     fi
+    if [[ -x "${BUILD_DIR}/tests/test_mdbx_impl" ]]; then
+        test_files+=("${BUILD_DIR}/tests/test_mdbx_impl")
+    fi
     if [[ -x "${BUILD_DIR}/tests/test_mdbx_demand" ]]; then
         test_files+=("${BUILD_DIR}/tests/test_mdbx_demand")
     fi
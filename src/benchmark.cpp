@@ -1,7 +1,11 @@
 #include "core/query_engine.hpp"
+#include "db/mdbx.hpp"
 #include "db/mdbx_impl.hpp"
+#include "utils/key_schema.hpp"
 #if HAVE_ROCKSDB
 #include "db/rocksdb_impl.hpp"
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
 #endif
 
 #include <benchmark/benchmark.h>
@@ -14,6 +18,7 @@
 #include <vector>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <mutex>
 
 // --- Test Data Configuration ---
@@ -108,6 +113,21 @@ public:
             auto temp_mdbx_engine = std::make_unique<QueryEngine>(std::make_unique<MdbxImpl>(mdbx_path_));
             populate_database(*temp_mdbx_engine);
             temp_mdbx_engine.reset(); // Close connection after populating data
+
+            // Same data in the history chunk layout, stored in its own table of the same environment
+            auto temp_chunked_engine = std::make_unique<QueryEngine>(
+                std::make_unique<MdbxImpl>(mdbx_path_, MdbxLayout::kHistoryChunks));
+            populate_database(*temp_chunked_engine);
+            temp_chunked_engine.reset();
+
+#if HAVE_ZSTD || HAVE_LZ4
+            // Same data with compressed values, in the ".z" tables of the same environment
+            for (const auto layout : {MdbxLayout::kVersionPerKey, MdbxLayout::kHistoryChunks}) {
+                auto temp_compressed_engine =
+                    std::make_unique<QueryEngine>(std::make_unique<MdbxImpl>(mdbx_path_, compressed_options(layout)));
+                populate_database(*temp_compressed_engine);
+            }
+#endif
             mdbx_data_initialized = true;
         }
         
@@ -118,6 +138,12 @@ public:
             auto temp_rocksdb_engine = std::make_unique<QueryEngine>(std::make_unique<RocksDbImpl>(rocksdb_path_));
             populate_database(*temp_rocksdb_engine);
             temp_rocksdb_engine.reset(); // Close connection after populating data
+
+            // Same data without prefix extractor nor prefix bloom filter, as a total order seek baseline
+            auto temp_total_order_engine = std::make_unique<QueryEngine>(
+                std::make_unique<RocksDbImpl>(rocksdb_total_order_path_, total_order_config()));
+            populate_database(*temp_total_order_engine);
+            temp_total_order_engine.reset();
             rocksdb_data_initialized = true;
         }
 #endif
@@ -168,9 +194,45 @@ protected:
         }
     }
 
+    // Reports the on-disk footprint of the account table per stored version
+    static void report_bytes_per_version(benchmark::State& state, const MdbxImpl& db) {
+        const double versions = static_cast<double>(NUM_ACCOUNTS * NUM_BLOCKS_PER_ACCOUNT);
+        state.counters["bytes_per_version"] = static_cast<double>(db.storage_bytes()) / versions;
+    }
+
+#if HAVE_ZSTD || HAVE_LZ4
+    // Value compression of the MDBX_Compressed benchmarks: zstd with a trained dictionary when built in, else LZ4
+    static auto compressed_options(MdbxLayout layout) -> MdbxOptions {
+        MdbxOptions options{.layout = layout, .hot_cache_entries = 1024};
+        options.values.compression = HAVE_ZSTD ? ValueCompression::kZstd : ValueCompression::kLz4;
+        return options;
+    }
+#endif
+
+#if HAVE_ROCKSDB
+    static auto total_order_config() -> RocksDBConfig {
+        RocksDBConfig config;
+        config.prefix_bloom = false;
+        return config;
+    }
+
+    // Reports the per-query work of the RocksDB seek path, from the thread-local perf context
+    static void report_seek_io(benchmark::State& state) {
+        const auto* perf = rocksdb::get_perf_context();
+        const auto per_query = [](uint64_t count) {
+            return benchmark::Counter(static_cast<double>(count), benchmark::Counter::kAvgIterations);
+        };
+        state.counters["sst_blocks_read"] = per_query(perf->block_read_count);
+        state.counters["block_cache_hits"] = per_query(perf->block_cache_hit_count);
+        state.counters["bloom_sst_skips"] = per_query(perf->bloom_sst_miss_count);
+        state.counters["keys_skipped"] = per_query(perf->internal_key_skipped_count);
+    }
+#endif
+
     void cleanup_databases() {
         std::filesystem::remove_all(mdbx_path_);
         std::filesystem::remove_all(rocksdb_path_);
+        std::filesystem::remove_all(rocksdb_total_order_path_);
     }
 
     // Test data (shared across all tests using static members)
@@ -181,6 +243,8 @@ protected:
     // Database paths (shared across all tests)
     static inline const std::filesystem::path mdbx_path_ = std::filesystem::temp_directory_path() / "benchmark_mdbx";
     static inline const std::filesystem::path rocksdb_path_ = std::filesystem::temp_directory_path() / "benchmark_rocksdb";
+    static inline const std::filesystem::path rocksdb_total_order_path_ =
+        std::filesystem::temp_directory_path() / "benchmark_rocksdb_total_order";
 
     // Both MDBX and RocksDB instances are created per-benchmark, no shared instances needed
 };
@@ -204,7 +268,9 @@ BENCHMARK_F(DatabaseBenchmark, MDBX_ExactMatch)(benchmark::State& state) {
 
 BENCHMARK_F(DatabaseBenchmark, MDBX_Lookback)(benchmark::State& state) {
     // Create independent MDBX connection for this benchmark
-    auto mdbx_engine = std::make_unique<QueryEngine>(std::make_unique<MdbxImpl>(mdbx_path_));
+    auto mdbx_db = std::make_unique<MdbxImpl>(mdbx_path_);
+    const MdbxImpl& mdbx_ref = *mdbx_db;
+    auto mdbx_engine = std::make_unique<QueryEngine>(std::move(mdbx_db));
     
     size_t query_idx = 0;
     for (auto _ : state) {
@@ -215,9 +281,79 @@ BENCHMARK_F(DatabaseBenchmark, MDBX_Lookback)(benchmark::State& state) {
     }
 
     state.SetItemsProcessed(state.iterations());
+    report_bytes_per_version(state, mdbx_ref);
     // MDBX connection will be automatically closed when mdbx_engine goes out of scope
 }
 
+// --- MDBX History Chunk Benchmarks ---
+BENCHMARK_F(DatabaseBenchmark, MDBX_Chunked_ExactMatch)(benchmark::State& state) {
+    auto mdbx_engine = std::make_unique<QueryEngine>(std::make_unique<MdbxImpl>(mdbx_path_, MdbxLayout::kHistoryChunks));
+
+    size_t query_idx = 0;
+    for (auto _ : state) {
+        const auto& [account, block] = exact_queries_[query_idx % exact_queries_.size()];
+        auto result = mdbx_engine->find_account_state(account, block);
+        benchmark::DoNotOptimize(result);
+        ++query_idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_F(DatabaseBenchmark, MDBX_Chunked_Lookback)(benchmark::State& state) {
+    auto mdbx_db = std::make_unique<MdbxImpl>(mdbx_path_, MdbxLayout::kHistoryChunks);
+    const MdbxImpl& mdbx_ref = *mdbx_db;
+    auto mdbx_engine = std::make_unique<QueryEngine>(std::move(mdbx_db));
+
+    size_t query_idx = 0;
+    for (auto _ : state) {
+        const auto& [account, block] = lookback_queries_[query_idx % lookback_queries_.size()];
+        auto result = mdbx_engine->find_account_state(account, block);
+        benchmark::DoNotOptimize(result);
+        ++query_idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    report_bytes_per_version(state, mdbx_ref);
+}
+
+// --- MDBX Compressed Value Benchmarks ---
+#if HAVE_ZSTD || HAVE_LZ4
+BENCHMARK_F(DatabaseBenchmark, MDBX_Compressed_Lookback)(benchmark::State& state) {
+    auto mdbx_db = std::make_unique<MdbxImpl>(mdbx_path_, compressed_options(MdbxLayout::kVersionPerKey));
+    const MdbxImpl& mdbx_ref = *mdbx_db;
+    auto mdbx_engine = std::make_unique<QueryEngine>(std::move(mdbx_db));
+
+    size_t query_idx = 0;
+    for (auto _ : state) {
+        const auto& [account, block] = lookback_queries_[query_idx % lookback_queries_.size()];
+        auto result = mdbx_engine->find_account_state(account, block);
+        benchmark::DoNotOptimize(result);
+        ++query_idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    report_bytes_per_version(state, mdbx_ref);
+}
+
+BENCHMARK_F(DatabaseBenchmark, MDBX_Chunked_Compressed_Lookback)(benchmark::State& state) {
+    auto mdbx_db = std::make_unique<MdbxImpl>(mdbx_path_, compressed_options(MdbxLayout::kHistoryChunks));
+    const MdbxImpl& mdbx_ref = *mdbx_db;
+    auto mdbx_engine = std::make_unique<QueryEngine>(std::move(mdbx_db));
+
+    size_t query_idx = 0;
+    for (auto _ : state) {
+        const auto& [account, block] = lookback_queries_[query_idx % lookback_queries_.size()];
+        auto result = mdbx_engine->find_account_state(account, block);
+        benchmark::DoNotOptimize(result);
+        ++query_idx;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    report_bytes_per_version(state, mdbx_ref);
+}
+#endif
+
 // --- RocksDB Benchmarks ---
 #if HAVE_ROCKSDB
 BENCHMARK_F(DatabaseBenchmark, RocksDB_ExactMatch)(benchmark::State& state) {
@@ -240,6 +376,8 @@ BENCHMARK_F(DatabaseBenchmark, RocksDB_Lookback)(benchmark::State& state) {
     // Create independent RocksDB connection for this benchmark
     auto rocksdb_engine = std::make_unique<QueryEngine>(std::make_unique<RocksDbImpl>(rocksdb_path_));
     
+    rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+    rocksdb::get_perf_context()->Reset();
     size_t query_idx = 0;
     for (auto _ : state) {
         const auto& [account, block] = lookback_queries_[query_idx % lookback_queries_.size()];
@@ -247,12 +385,130 @@ BENCHMARK_F(DatabaseBenchmark, RocksDB_Lookback)(benchmark::State& state) {
         benchmark::DoNotOptimize(result);
         ++query_idx;
     }
+    report_seek_io(state);
+    rocksdb::SetPerfLevel(rocksdb::PerfLevel::kDisable);
 
     state.SetItemsProcessed(state.iterations());
     // RocksDB connection will be automatically closed when rocksdb_engine goes out of scope
 }
+
+// Same lookbacks as RocksDB_Lookback on a database without prefix extractor: every SeekForPrev consults all the
+// overlapping SST files, compare sst_blocks_read and bloom_sst_skips between both
+BENCHMARK_F(DatabaseBenchmark, RocksDB_Lookback_TotalOrder)(benchmark::State& state) {
+    auto rocksdb_engine = std::make_unique<QueryEngine>(
+        std::make_unique<RocksDbImpl>(rocksdb_total_order_path_, total_order_config()));
+
+    rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+    rocksdb::get_perf_context()->Reset();
+    size_t query_idx = 0;
+    for (auto _ : state) {
+        const auto& [account, block] = lookback_queries_[query_idx % lookback_queries_.size()];
+        auto result = rocksdb_engine->find_account_state(account, block);
+        benchmark::DoNotOptimize(result);
+        ++query_idx;
+    }
+    report_seek_io(state);
+    rocksdb::SetPerfLevel(rocksdb::PerfLevel::kDisable);
+
+    state.SetItemsProcessed(state.iterations());
+}
 #endif
 
+// --- Composite Key Comparator Benchmarks ---
+// (20-byte address ‖ big-endian block) keys, as written by set_account_state for address-sized account names.
+// Argument 0 uses the default memcmp collation, argument 1 the specialised compare_address20_block_keys.
+static auto make_composite_keys(size_t num_accounts, size_t blocks_per_account) -> std::vector<std::string> {
+    std::mt19937_64 gen{42};
+    std::vector<std::string> keys;
+    keys.reserve(num_accounts * blocks_per_account);
+    for (size_t i = 0; i < num_accounts; ++i) {
+        utils::Address20::value_type address;
+        for (auto& byte : address) {
+            byte = static_cast<std::byte>(gen());
+        }
+        for (size_t b = 0; b < blocks_per_account; ++b) {
+            const auto key = utils::AccountHistoryKey::encode(address, b * 7 + 1);
+            keys.emplace_back(reinterpret_cast<const char*>(key.data()), key.size());
+        }
+    }
+    return keys;
+}
+
+static int memcmp_keys(const MDBX_val* lhs, const MDBX_val* rhs) {
+    const int result = std::memcmp(lhs->iov_base, rhs->iov_base, std::min(lhs->iov_len, rhs->iov_len));
+    return result != 0 ? result : (lhs->iov_len < rhs->iov_len ? -1 : (lhs->iov_len > rhs->iov_len ? 1 : 0));
+}
+
+static void CompositeKey_Compare(benchmark::State& state) {
+    // Keys of the same account only differ in the block suffix: the worst case for both comparators
+    const auto keys = make_composite_keys(64, 64);
+    const auto compare = state.range(0) == 0 ? memcmp_keys : datastore::kvdb::compare_address20_block_keys;
+    std::mt19937 gen{123};
+    std::uniform_int_distribution<size_t> dist{0, keys.size() - 1};
+    std::vector<std::pair<MDBX_val, MDBX_val>> pairs(4096);
+    for (auto& [a, b] : pairs) {
+        const size_t i = dist(gen);
+        const size_t j = (i & ~size_t{63}) | (dist(gen) & 63);
+        a = MDBX_val{const_cast<char*>(keys[i].data()), keys[i].size()};
+        b = MDBX_val{const_cast<char*>(keys[j].data()), keys[j].size()};
+    }
+    size_t idx = 0;
+    for (auto _ : state) {
+        const auto& [a, b] = pairs[idx++ % pairs.size()];
+        benchmark::DoNotOptimize(compare(&a, &b));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(CompositeKey_Compare)->Arg(0)->Arg(1);
+
+static void MDBX_CompositeKeyDescent(benchmark::State& state) {
+    using namespace datastore::kvdb;
+    const auto db_path = std::filesystem::temp_directory_path() / fmt::format("benchmark_mdbx_cmp_{}", state.range(0));
+    std::filesystem::remove_all(db_path);
+
+    {
+        EnvConfig env_config;
+        env_config.path = db_path.string();
+        env_config.create = true;
+        env_config.max_size = 4_Gibi;
+        env_config.growth_size = 64_Mebi;
+        auto env = open_env(env_config);
+        const MapConfig map_config{"AccountState", ::mdbx::key_mode::usual, ::mdbx::value_mode::single,
+                                   state.range(0) == 0 ? nullptr : compare_address20_block_keys};
+
+        const auto keys = make_composite_keys(NUM_ACCOUNTS * 100, NUM_BLOCKS_PER_ACCOUNT);
+        {
+            RWTxnManaged txn{env};
+            auto cursor = txn.rw_cursor(map_config);
+            for (const auto& key : keys) {
+                cursor->upsert(Slice{key.data(), key.size()}, Slice{key.data(), sizeof(uint64_t)});
+            }
+            txn.commit_and_stop();
+        }
+
+        // Lookback style seeks: the block just above an existing one lands between two keys of the same account
+        std::mt19937 gen{123};
+        std::uniform_int_distribution<size_t> dist{0, keys.size() - 1};
+        std::vector<std::string> seeks(4096);
+        for (auto& seek : seeks) {
+            seek = keys[dist(gen)];
+            seek.back() = static_cast<char>(seek.back() + 1);
+        }
+
+        ROTxnManaged txn{env};
+        auto cursor = txn.ro_cursor(map_config);
+        size_t idx = 0;
+        for (auto _ : state) {
+            const auto& seek = seeks[idx++ % seeks.size()];
+            benchmark::DoNotOptimize(cursor->lower_bound(Slice{seek.data(), seek.size()}, false));
+        }
+        state.SetItemsProcessed(state.iterations());
+        txn.abort();
+    }
+    std::filesystem::remove_all(db_path);
+}
+BENCHMARK(MDBX_CompositeKeyDescent)->Arg(0)->Arg(1);
+
 // Cleanup function to be called at process exit
 void cleanup_at_exit() {
     try {
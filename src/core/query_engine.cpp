@@ -1,21 +1,57 @@
 #include "core/query_engine.hpp"
-#include "utils/endian.hpp"
+#include "utils/composite_key.hpp"
+#include "utils/metrics.hpp"
 
 #include <cstdint>
 #include <utility> // For std::move
 
+namespace {
+
+// End-to-end metrics of the QueryEngine operations, above the backend ones
+struct EngineMetrics {
+    struct Op {
+        utils::Counter& calls;
+        utils::Histogram& latency;
+    };
+
+    static auto op(const char* name) -> Op {
+        const auto labels = std::string{"op=\""} + name + "\"";
+        auto& registry = utils::MetricsRegistry::instance();
+        return Op{registry.counter("query_engine_ops_total", labels, "Calls of the QueryEngine operations"),
+                  registry.histogram("query_engine_op_duration_seconds", labels,
+                                     "Latency of the QueryEngine operations")};
+    }
+
+    Op set_account_state = op("set_account_state");
+    Op import_block = op("import_block");
+    Op find_account_state = op("find_account_state");
+    Op find_account_states = op("find_account_states");
+    utils::Counter& found = utils::MetricsRegistry::instance().counter(
+        "query_engine_lookups_total", "result=\"found\"", "Account states looked up, by outcome");
+    utils::Counter& missing = utils::MetricsRegistry::instance().counter(
+        "query_engine_lookups_total", "result=\"missing\"", "Account states looked up, by outcome");
+    utils::Counter& imported_changes = utils::MetricsRegistry::instance().counter(
+        "query_engine_imported_changes_total", "", "Account changes stored by import_block");
+};
+
+auto engine_metrics() -> const EngineMetrics& {
+    static const EngineMetrics metrics;
+    return metrics;
+}
+
+} // namespace
+
 QueryEngine::QueryEngine(std::unique_ptr<IDatabase> db) : db_{std::move(db)} {}
 
 void QueryEngine::set_account_state(std::string_view account_name, uint64_t block_number, std::string_view state) {
-    // Construct the composite key: account_name + big_endian(block_number)
-    std::vector<std::byte> key;
-    key.reserve(account_name.length() + sizeof(uint64_t));
-    key.insert(key.end(),
-               reinterpret_cast<const std::byte*>(account_name.data()),
-               reinterpret_cast<const std::byte*>(account_name.data()) + account_name.length());
+    const auto& metrics = engine_metrics();
+    const utils::ScopedLatency latency{metrics.set_account_state.latency};
+    if (utils::metrics_enabled()) {
+        metrics.set_account_state.calls.add();
+    }
 
-    const auto be_block = utils::to_big_endian_bytes(block_number);
-    key.insert(key.end(), be_block.begin(), be_block.end());
+    // Construct the composite key on the stack: account_name + big_endian(block_number)
+    const utils::CompositeKey key{account_name, block_number};
 
     // Convert state to a span of bytes
     std::span<const std::byte> value_span{reinterpret_cast<const std::byte*>(state.data()), state.size()};
@@ -23,9 +59,39 @@ void QueryEngine::set_account_state(std::string_view account_name, uint64_t bloc
     db_->put(key, value_span);
 }
 
+void QueryEngine::import_block(uint64_t block_number, std::span<const AccountStateChange> changes,
+                               Durability durability) {
+    const auto& metrics = engine_metrics();
+    const utils::ScopedLatency latency{metrics.import_block.latency};
+    if (utils::metrics_enabled()) {
+        metrics.import_block.calls.add();
+        metrics.imported_changes.add(changes.size());
+    }
+
+    WriteBatch batch;
+    size_t bytes = 0;
+    for (const auto& change : changes) {
+        bytes += change.account_name.length() + sizeof(uint64_t) + change.state.size();
+    }
+    batch.reserve(changes.size(), bytes);
+
+    for (const auto& change : changes) {
+        const utils::CompositeKey key{change.account_name, block_number};
+        batch.put(key, std::as_bytes(std::span{change.state.data(), change.state.size()}));
+    }
+
+    db_->write(std::move(batch), durability);
+}
+
 auto QueryEngine::find_account_state(std::string_view account_name, uint64_t block_number)
     -> std::optional<std::string> {
+    const auto& metrics = engine_metrics();
+    const utils::ScopedLatency latency{metrics.find_account_state.latency};
     auto result_bytes = db_->get_state(account_name, block_number);
+    if (utils::metrics_enabled()) {
+        metrics.find_account_state.calls.add();
+        (result_bytes ? metrics.found : metrics.missing).add();
+    }
 
     if (result_bytes) {
         // Convert the resulting byte vector back to a string for the application layer.
@@ -34,3 +100,26 @@ auto QueryEngine::find_account_state(std::string_view account_name, uint64_t blo
 
     return std::nullopt;
 }
+
+auto QueryEngine::find_account_states(std::span<const StateQuery> queries) -> std::vector<std::optional<std::string>> {
+    const auto& metrics = engine_metrics();
+    const utils::ScopedLatency latency{metrics.find_account_states.latency};
+    auto results_bytes = db_->get_states(queries);
+    if (utils::metrics_enabled()) {
+        metrics.find_account_states.calls.add();
+        for (const auto& result_bytes : results_bytes) {
+            (result_bytes ? metrics.found : metrics.missing).add();
+        }
+    }
+
+    std::vector<std::optional<std::string>> results;
+    results.reserve(results_bytes.size());
+    for (const auto& result_bytes : results_bytes) {
+        if (result_bytes) {
+            results.emplace_back(std::in_place, reinterpret_cast<const char*>(result_bytes->data()), result_bytes->size());
+        } else {
+            results.emplace_back(std::nullopt);
+        }
+    }
+    return results;
+}
@@ -4,10 +4,20 @@
 
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 #include <cstdint>
 
+/**
+ * @brief New state of one account, as changed by a block.
+ */
+struct AccountStateChange {
+    std::string_view account_name;
+    std::string_view state;
+};
+
 class QueryEngine {
 public:
     /**
@@ -21,9 +31,20 @@ public:
      * @param account_name The name of the account.
      * @param block_number The block number for the state entry.
      * @param state The state data to store.
+     * @throws std::length_error if account_name is longer than utils::kMaxAccountNameLength (128 bytes).
      */
     void set_account_state(std::string_view account_name, uint64_t block_number, std::string_view state);
 
+    /**
+     * @brief Stores all the account changes of a block atomically, in a single database write.
+     * @param block_number The block number for all the state entries.
+     * @param changes The new states of the accounts touched by the block.
+     * @param durability Whether the block must reach stable storage before returning.
+     * @throws std::length_error if an account name is longer than utils::kMaxAccountNameLength (128 bytes).
+     */
+    void import_block(uint64_t block_number, std::span<const AccountStateChange> changes,
+                      Durability durability = Durability::kSync);
+
     /**
      * @brief Finds the state of an account at a specific block, performing a lookback if necessary.
      * @param account_name The name of the account to query.
@@ -32,6 +53,13 @@ public:
      */
     auto find_account_state(std::string_view account_name, uint64_t block_number) -> std::optional<std::string>;
 
+    /**
+     * @brief Finds the states of several accounts at once, each at its own block.
+     * @param queries The accounts and blocks to query.
+     * @return The state found for each query, in the order of queries.
+     */
+    auto find_account_states(std::span<const StateQuery> queries) -> std::vector<std::optional<std::string>>;
+
 private:
     std::unique_ptr<IDatabase> db_;
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "utils/metrics.hpp"
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Metrics of an IDatabase backend, each series labelled with the backend name.
+ */
+struct DbMetrics {
+    struct Op {
+        utils::Counter& calls;
+        utils::Histogram& latency;
+    };
+
+    explicit DbMetrics(std::string_view backend)
+        : put{op(backend, "put")},
+          write{op(backend, "write")},
+          get_state{op(backend, "get_state")},
+          get_states{op(backend, "get_states")},
+          read_bytes{utils::MetricsRegistry::instance().counter(
+              "db_read_bytes_total", fmt::format("backend=\"{}\"", backend), "Bytes of the states returned")},
+          written_bytes{utils::MetricsRegistry::instance().counter(
+              "db_written_bytes_total", fmt::format("backend=\"{}\"", backend), "Bytes of the keys and values written")} {}
+
+    /**
+     * @brief Counts one call of op having read and written that many bytes, when metrics are enabled.
+     */
+    void count(const Op& op, uint64_t bytes_read, uint64_t bytes_written) const {
+        if (!utils::metrics_enabled()) {
+            return;
+        }
+        op.calls.add();
+        if (bytes_read > 0) read_bytes.add(bytes_read);
+        if (bytes_written > 0) written_bytes.add(bytes_written);
+    }
+
+    /**
+     * @brief Returns the hit and miss counters of a cache of the backend.
+     */
+    static auto cache(std::string_view backend, std::string_view cache, bool hit) -> utils::Counter& {
+        return utils::MetricsRegistry::instance().counter(
+            "db_cache_lookups_total",
+            fmt::format("backend=\"{}\",cache=\"{}\",result=\"{}\"", backend, cache, hit ? "hit" : "miss"),
+            "Lookups in the caches of the backends");
+    }
+
+    Op put;
+    Op write;
+    Op get_state;
+    Op get_states;
+    utils::Counter& read_bytes;
+    utils::Counter& written_bytes;
+
+private:
+    static auto op(std::string_view backend, std::string_view name) -> Op {
+        const auto labels = fmt::format("backend=\"{}\",op=\"{}\"", backend, name);
+        auto& registry = utils::MetricsRegistry::instance();
+        return Op{registry.counter("db_ops_total", labels, "Calls of the IDatabase operations"),
+                  registry.histogram("db_op_duration_seconds", labels, "Latency of the IDatabase operations")};
+    }
+};
@@ -6,17 +6,36 @@
 #include <vector>
 #include <cstdint>
 
+#include "db/write_batch.hpp"
+
+/**
+ * @brief One "state of an account as of a block" query.
+ */
+struct StateQuery {
+    std::string_view account_name;
+    uint64_t block_number;
+};
+
 class IDatabase {
 public:
     virtual ~IDatabase() = default;
 
     /**
      * @brief Inserts a key-value pair into the database.
-     * @param key The key to insert.
+     * @param key The key to insert, `account_name + big_endian(block_number)`.
      * @param value The value associated with the key.
+     * @throws std::length_error if the account name is longer than utils::kMaxAccountNameLength (128 bytes).
      */
     virtual void put(std::span<const std::byte> key, std::span<const std::byte> value) = 0;
 
+    /**
+     * @brief Applies all the puts of a batch atomically: either all of them are visible or none.
+     * @param batch The batch to apply, consumed by the call.
+     * @param durability Whether the write must reach stable storage before returning.
+     * @throws std::length_error if an account name is longer than utils::kMaxAccountNameLength, nothing is written.
+     */
+    virtual void write(WriteBatch&& batch, Durability durability) = 0;
+
     /**
      * @brief Retrieves the state for a given account at a specific block number,
      * or the most recent state before that block number if an exact match is not found.
@@ -26,4 +45,20 @@ public:
      * @return An optional containing the state as a vector of bytes if found, otherwise std::nullopt.
      */
     virtual auto get_state(std::string_view account_name, uint64_t block_number) -> std::optional<std::vector<std::byte>> = 0;
+
+    /**
+     * @brief Resolves several get_state queries in one call, letting the backend order and batch the lookups.
+     *
+     * The default implementation calls get_state for each query.
+     * @param queries The queries to resolve.
+     * @return The result of each query, in the order of queries.
+     */
+    virtual auto get_states(std::span<const StateQuery> queries) -> std::vector<std::optional<std::vector<std::byte>>> {
+        std::vector<std::optional<std::vector<std::byte>>> results;
+        results.reserve(queries.size());
+        for (const auto& query : queries) {
+            results.push_back(get_state(query.account_name, query.block_number));
+        }
+        return results;
+    }
 };
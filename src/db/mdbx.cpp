@@ -3,7 +3,22 @@
 
 #include "mdbx.hpp"
 
+#include "mdbx_fast_cursor.hpp"
+#include "mdbx_heatmap.hpp"
+#include "../utils/endian.hpp"
+#include "../utils/key_schema.hpp"
+#include "../utils/metrics.hpp"
+#include "../utils/simd_compare.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <stdexcept>
+#include <thread>
 
 namespace datastore::kvdb {
 
@@ -21,6 +36,31 @@ namespace detail {
     std::string slice_as_hex(const Slice& data) {
         return std::string(::mdbx::to_hex(data).as_string());
     }
+
+    std::vector<std::byte> key_midpoint(std::span<const std::byte> lhs, std::span<const std::byte> rhs) {
+        // One extra digit keeps the low bit shifted out by the halving
+        const size_t length{std::max(lhs.size(), rhs.size()) + 1};
+        std::vector<unsigned> sum(length, 0);
+        unsigned carry{0};
+        for (size_t i{length}; i-- > 0;) {
+            const unsigned l{i < lhs.size() ? std::to_integer<unsigned>(lhs[i]) : 0u};
+            const unsigned r{i < rhs.size() ? std::to_integer<unsigned>(rhs[i]) : 0u};
+            sum[i] = l + r + carry;
+            carry = sum[i] >> 8;
+            sum[i] &= 0xFF;
+        }
+        std::vector<std::byte> mid(length);
+        unsigned remainder{carry};
+        for (size_t i{0}; i < length; ++i) {
+            const unsigned value{(remainder << 8) | sum[i]};
+            mid[i] = static_cast<std::byte>(value >> 1);
+            remainder = value & 1u;
+        }
+        while (!mid.empty() && mid.back() == std::byte{0}) {
+            mid.pop_back();
+        }
+        return mid;
+    }
 }  // namespace detail
 
 //! \brief Returns data of current cursor position or moves it to the beginning or the end of the table based on
@@ -50,6 +90,13 @@ static CursorResult strict_lower_bound(ROCursor& cursor, const ByteView key) {
     return cursor.to_previous(/*throw_notfound=*/false);
 }
 
+// Passes read positions through the access heatmap sampling
+template <typename Result>
+static Result sampled(Result result) {
+    detail::sample_heatmap(result);
+    return result;
+}
+
 static mdbx::cursor::move_operation move_operation(CursorMoveDirection direction) {
     return direction == CursorMoveDirection::kForward
                ? mdbx::cursor::move_operation::next
@@ -176,12 +223,60 @@ static mdbx::cursor::move_operation move_operation(CursorMoveDirection direction
 }
 
 ::mdbx::map_handle open_map(::mdbx::txn& tx, const MapConfig& config) {
+    if (config.key_comparator) {
+        // The C++ API has no way to pass a comparator: go through the (deprecated but supported) C extension
+        auto flags{static_cast<unsigned>(config.key_mode) | static_cast<unsigned>(config.value_mode)};
+        if (!tx.is_readonly()) {
+            flags |= MDBX_CREATE;
+        }
+        MDBX_dbi dbi{0};
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        ::mdbx::error::success_or_throw(::mdbx_dbi_open_ex(tx, config.name_str().c_str(),
+                                                           static_cast<MDBX_db_flags_t>(flags), &dbi,
+                                                           config.key_comparator, nullptr));
+#pragma GCC diagnostic pop
+        return ::mdbx::map_handle{dbi};
+    }
     if (tx.is_readonly()) {
         return tx.open_map(config.name_str(), config.key_mode, config.value_mode);
     }
     return tx.create_map(config.name_str(), config.key_mode, config.value_mode);
 }
 
+namespace {
+    template <size_t kAddressSize>
+    int compare_address_block_keys(const MDBX_val* lhs, const MDBX_val* rhs) noexcept {
+        using Schema = utils::KeySchema<utils::FixedBytes<kAddressSize>, utils::BlockBE64>;
+        static_assert(kAddressSize >= sizeof(uint64_t));
+        const ByteView a{static_cast<const std::byte*>(lhs->iov_base), lhs->iov_len};
+        const ByteView b{static_cast<const std::byte*>(rhs->iov_base), rhs->iov_len};
+        if (!Schema::matches(a) || !Schema::matches(b)) [[unlikely]] {
+            const auto order{utils::compare_bytes(a, b)};
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+        }
+        // Big-endian words compare numerically in the same order memcmp compares their bytes. A trailing partial word
+        // is loaded overlapping the previous one, whose bytes are already known to be equal.
+        for (size_t offset{0}; offset < kAddressSize; offset += sizeof(uint64_t)) {
+            const size_t at{std::min(offset, kAddressSize - sizeof(uint64_t))};
+            const uint64_t x{utils::load_big_endian_u64(a.data() + at)};
+            const uint64_t y{utils::load_big_endian_u64(b.data() + at)};
+            if (x != y) return x < y ? -1 : 1;
+        }
+        const uint64_t x{Schema::template get<1>(a.first<Schema::kSize>())};
+        const uint64_t y{Schema::template get<1>(b.first<Schema::kSize>())};
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+}  // namespace
+
+int compare_address20_block_keys(const MDBX_val* lhs, const MDBX_val* rhs) noexcept {
+    return compare_address_block_keys<20>(lhs, rhs);
+}
+
+int compare_address32_block_keys(const MDBX_val* lhs, const MDBX_val* rhs) noexcept {
+    return compare_address_block_keys<32>(lhs, rhs);
+}
+
 ::mdbx::cursor_managed open_cursor(::mdbx::txn& tx, const MapConfig& config) {
     return tx.open_cursor(open_map(tx, config));
 }
@@ -236,21 +331,50 @@ std::unique_ptr<RWCursorDupSort> RWTxn::rw_cursor_dup_sort(const MapConfig& conf
     return std::make_unique<PooledCursor>(*this, config);
 }
 
+namespace {
+
+    struct TxnMetrics {
+        utils::Counter& commits{utils::MetricsRegistry::instance().counter(
+            "mdbx_txn_commits_total", "", "Write transactions committed through RWTxnManaged")};
+        utils::Histogram& duration{utils::MetricsRegistry::instance().histogram(
+            "mdbx_txn_duration_seconds", "", "Time from the start of a write transaction to the end of its commit")};
+        utils::Histogram& commit{utils::MetricsRegistry::instance().histogram(
+            "mdbx_txn_commit_duration_seconds", "", "Time spent committing a write transaction")};
+    };
+
+}  // namespace
+
+void RWTxnManaged::commit_and_record() {
+    if (!utils::metrics_enabled()) {
+        managed_txn_.commit();
+        return;
+    }
+    // Not sampled: commits are rare next to reads and writes, two clock reads each are noise
+    static const TxnMetrics metrics;
+    const auto commit_start{std::chrono::steady_clock::now()};
+    managed_txn_.commit();
+    const auto commit_end{std::chrono::steady_clock::now()};
+    metrics.commits.add();
+    metrics.commit.observe(std::chrono::duration_cast<std::chrono::nanoseconds>(commit_end - commit_start).count());
+    metrics.duration.observe(std::chrono::duration_cast<std::chrono::nanoseconds>(commit_end - started_).count());
+}
+
 void RWTxnManaged::commit_and_renew() {
     if (!commit_disabled_) {
         mdbx::env env = db();
-        managed_txn_.commit();
+        commit_and_record();
         managed_txn_ = env.start_write();  // renew transaction
+        started_ = std::chrono::steady_clock::now();
     }
 }
 
 void RWTxnManaged::commit_and_stop() {
     if (!commit_disabled_) {
-        managed_txn_.commit();
+        commit_and_record();
     }
 }
 
-thread_local ObjectPool<MDBX_cursor, detail::CursorHandleDeleter> PooledCursor::handles_pool_{};
+thread_local PooledCursor::HandlesPool PooledCursor::handles_pool_{};
 
 PooledCursor::PooledCursor() {
     handle_ = handles_pool_.acquire();
@@ -275,16 +399,20 @@ PooledCursor::PooledCursor(::mdbx::txn& txn, const MapConfig& config) {
     bind(txn, config);
 }
 
-PooledCursor::PooledCursor(PooledCursor&& other) noexcept { std::swap(handle_, other.handle_); }
+PooledCursor::PooledCursor(PooledCursor&& other) noexcept {
+    std::swap(handle_, other.handle_);
+    std::swap(origin_pool_, other.origin_pool_);
+}
 
 PooledCursor& PooledCursor::operator=(PooledCursor&& other) noexcept {
     std::swap(handle_, other.handle_);
+    std::swap(origin_pool_, other.origin_pool_);
     return *this;
 }
 
 PooledCursor::~PooledCursor() {
     if (handle_) {
-        handles_pool_.add(handle_);
+        handles_pool_.add(handle_, origin_pool_);
     }
 }
 
@@ -296,6 +424,7 @@ void PooledCursor::bind(ROTxn& txn, ::mdbx::map_handle map) {
         if (txn->id() != mdbx_txn_id(cm_tx)) {
             close();
             handle_ = ::mdbx_cursor_create(nullptr);
+            origin_pool_ = &handles_pool_;
         }
     }
     ::mdbx::cursor::bind(*txn, map);
@@ -309,6 +438,7 @@ void PooledCursor::bind(::mdbx::txn& txn, const MapConfig& config) {
         if (txn.id() != mdbx_txn_id(cm_tx)) {
             close();
             handle_ = ::mdbx_cursor_create(nullptr);
+            origin_pool_ = &handles_pool_;
         }
     }
     const auto map{open_map(txn, config)};
@@ -362,11 +492,11 @@ CursorResult PooledCursor::to_first(bool throw_notfound) {
 }
 
 CursorResult PooledCursor::to_previous() {
-    return ::mdbx::cursor::to_previous(/*throw_notfound =*/true);
+    return sampled(::mdbx::cursor::to_previous(/*throw_notfound =*/true));
 }
 
 CursorResult PooledCursor::to_previous(bool throw_notfound) {
-    return ::mdbx::cursor::to_previous(throw_notfound);
+    return sampled(::mdbx::cursor::to_previous(throw_notfound));
 }
 
 CursorResult PooledCursor::current() const {
@@ -378,11 +508,11 @@ CursorResult PooledCursor::current(bool throw_notfound) const {
 }
 
 CursorResult PooledCursor::to_next() {
-    return ::mdbx::cursor::to_next(/*throw_notfound =*/true);
+    return sampled(::mdbx::cursor::to_next(/*throw_notfound =*/true));
 }
 
 CursorResult PooledCursor::to_next(bool throw_notfound) {
-    return ::mdbx::cursor::to_next(throw_notfound);
+    return sampled(::mdbx::cursor::to_next(throw_notfound));
 }
 
 CursorResult PooledCursor::to_last() {
@@ -394,27 +524,27 @@ CursorResult PooledCursor::to_last(bool throw_notfound) {
 }
 
 CursorResult PooledCursor::find(const Slice& key) {
-    return ::mdbx::cursor::find(key, /*throw_notfound =*/true);
+    return sampled(::mdbx::cursor::find(key, /*throw_notfound =*/true));
 }
 
 CursorResult PooledCursor::find(const Slice& key, bool throw_notfound) {
-    return ::mdbx::cursor::find(key, throw_notfound);
+    return sampled(::mdbx::cursor::find(key, throw_notfound));
 }
 
 CursorResult PooledCursor::lower_bound(const Slice& key) {
-    return ::mdbx::cursor::lower_bound(key, /*throw_notfound =*/true);
+    return sampled(::mdbx::cursor::lower_bound(key, /*throw_notfound =*/true));
 }
 
 CursorResult PooledCursor::lower_bound(const Slice& key, bool throw_notfound) {
-    return ::mdbx::cursor::lower_bound(key, throw_notfound);
+    return sampled(::mdbx::cursor::lower_bound(key, throw_notfound));
 }
 
 MoveResult PooledCursor::move(MoveOperation operation, bool throw_notfound) {
-    return ::mdbx::cursor::move(operation, throw_notfound);
+    return sampled(::mdbx::cursor::move(operation, throw_notfound));
 }
 
 MoveResult PooledCursor::move(MoveOperation operation, const Slice& key, bool throw_notfound) {
-    return ::mdbx::cursor::move(operation, key, throw_notfound);
+    return sampled(::mdbx::cursor::move(operation, key, throw_notfound));
 }
 
 bool PooledCursor::seek(const Slice& key) {
@@ -482,19 +612,19 @@ CursorResult PooledCursor::to_next_first_multi(bool throw_notfound) {
 }
 
 CursorResult PooledCursor::find_multivalue(const Slice& key, const Slice& value) {
-    return ::mdbx::cursor::find_multivalue(key, value, /*throw_notfound =*/true);
+    return sampled(::mdbx::cursor::find_multivalue(key, value, /*throw_notfound =*/true));
 }
 
 CursorResult PooledCursor::find_multivalue(const Slice& key, const Slice& value, bool throw_notfound) {
-    return ::mdbx::cursor::find_multivalue(key, value, throw_notfound);
+    return sampled(::mdbx::cursor::find_multivalue(key, value, throw_notfound));
 }
 
 CursorResult PooledCursor::lower_bound_multivalue(const Slice& key, const Slice& value) {
-    return ::mdbx::cursor::lower_bound_multivalue(key, value, /*throw_notfound =*/false);
+    return sampled(::mdbx::cursor::lower_bound_multivalue(key, value, /*throw_notfound =*/false));
 }
 
 CursorResult PooledCursor::lower_bound_multivalue(const Slice& key, const Slice& value, bool throw_notfound) {
-    return ::mdbx::cursor::lower_bound_multivalue(key, value, throw_notfound);
+    return sampled(::mdbx::cursor::lower_bound_multivalue(key, value, throw_notfound));
 }
 
 MoveResult PooledCursor::move(MoveOperation operation, const Slice& key, const Slice& value, bool throw_notfound) {
@@ -584,7 +714,7 @@ size_t cursor_for_prefix(ROCursor& cursor, const ByteView prefix, WalkFuncRef wa
     Slice prefix_slice{prefix.data(), prefix.size()};
     auto data{cursor.lower_bound(prefix_slice, false)};
     while (data) {
-        if (!data.key.starts_with(prefix_slice)) {
+        if (!utils::starts_with(from_slice(data.key), prefix)) {
             break;
         }
         ++ret;
@@ -594,12 +724,271 @@ size_t cursor_for_prefix(ROCursor& cursor, const ByteView prefix, WalkFuncRef wa
     return ret;
 }
 
+size_t find_batch(ROTxn& txn, const MapConfig& config, std::span<const ByteView> keys, BatchFindFuncRef walker,
+                  const BatchFindOptions& options) {
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    if (options.sort_keys) {
+        std::sort(order.begin(), order.end(), [&keys](size_t lhs, size_t rhs) {
+            return std::ranges::lexicographical_compare(keys[lhs], keys[rhs]);
+        });
+    }
+
+    // Positions in `order` already handed out to prefetchers and already resolved by the calling thread
+    std::atomic<size_t> next_prefetch{0};
+    std::atomic<size_t> resolved{0};
+
+    std::vector<std::jthread> prefetchers;
+    if (keys.size() > 1) {
+        const size_t num_threads{std::min(options.prefetch_threads, options.prefetch_distance)};
+        prefetchers.reserve(num_threads);
+        for (size_t i{0}; i < num_threads; ++i) {
+            prefetchers.emplace_back([&, env = txn.db()](const std::stop_token& stop) mutable {
+                try {
+                    ROTxnManaged prefetch_txn{env};
+                    PooledCursor prefetch_cursor{prefetch_txn, config};
+                    while (!stop.stop_requested()) {
+                        const size_t pos{next_prefetch.fetch_add(1, std::memory_order_relaxed)};
+                        if (pos >= order.size()) break;
+                        // Sleep until the resolving cursor gets within distance, notified on each resolved key
+                        size_t done{resolved.load(std::memory_order_acquire)};
+                        while (pos > done + options.prefetch_distance) {
+                            resolved.wait(done, std::memory_order_acquire);
+                            done = resolved.load(std::memory_order_acquire);
+                        }
+                        if (stop.stop_requested()) return;
+                        if (pos < done) continue;  // fell behind, skip
+                        const auto data{prefetch_cursor.find(to_slice(keys[order[pos]]), /*throw_notfound=*/false)};
+                        if (data.done && !data.value.empty()) {
+                            // Touch the value as well: for big values it may live on overflow pages
+                            [[maybe_unused]] volatile auto first_byte{*data.value.byte_ptr()};
+                        }
+                    }
+                } catch (const std::exception&) {
+                    // Prefetching is best effort only: a failing helper must not affect the lookups
+                }
+            });
+        }
+    }
+
+    // Wakes the waiting prefetchers however the lookups end (walker exceptions included), before they are joined
+    struct PrefetchRelease {
+        std::atomic<size_t>& resolved;
+        size_t end;
+        ~PrefetchRelease() {
+            resolved.store(end, std::memory_order_release);
+            resolved.notify_all();
+        }
+    } release{resolved, order.size()};
+
+    size_t found{0};
+    PooledCursor cursor{txn, config};
+    for (size_t pos{0}; pos < order.size(); ++pos) {
+        const auto data{cursor.find(to_slice(keys[order[pos]]), /*throw_notfound=*/false)};
+        if (data.done) {
+            ++found;
+        }
+        walker(order[pos], data);
+        resolved.store(pos + 1, std::memory_order_release);
+        if (!prefetchers.empty()) {
+            resolved.notify_all();
+        }
+    }
+    return found;  // prefetchers are stopped and joined on destruction
+}
+
+//! Number of partitions per thread in parallel_for_each, so that workers finishing early can steal the remaining ones
+static constexpr size_t kPartitionsPerThread{8};
+
+//! Number of sampled separator candidates per partition
+static constexpr size_t kSamplesPerPartition{8};
+
+static std::vector<std::byte> to_key_bytes(const Slice& slice) {
+    const ByteView view{from_slice(slice)};
+    return {view.begin(), view.end()};
+}
+
+static bool key_less(ByteView lhs, ByteView rhs) {
+    return std::ranges::lexicographical_compare(lhs, rhs);
+}
+
+// Splits the key space of the map in ranges holding about the same number of entries. MDBX does not expose branch
+// pages, so separator candidates are sampled by bisecting the key space and snapping the midpoints to actual keys,
+// then the gaps between candidates are weighted by the B-tree estimate of the number of entries they hold.
+// Returns the keys starting each partition but the first one
+static std::vector<std::vector<std::byte>> partition_key_space(ROTxn& txn, const MapConfig& config,
+                                                              size_t partitions) {
+    PooledCursor cursor{txn, config};
+    const auto first{cursor.to_first(/*throw_notfound=*/false)};
+    if (!first) return {};
+    const auto last{cursor.to_last(/*throw_notfound=*/false)};
+
+    std::vector<std::vector<std::byte>> samples{to_key_bytes(first.key), to_key_bytes(last.key)};
+    std::deque<std::pair<std::vector<std::byte>, std::vector<std::byte>>> ranges;
+    ranges.emplace_back(samples.front(), samples.back());
+    while (!ranges.empty() && samples.size() < partitions * kSamplesPerPartition) {
+        auto [lo, hi] = std::move(ranges.front());
+        ranges.pop_front();
+        const auto mid{detail::key_midpoint(lo, hi)};
+        const auto data{cursor.lower_bound(Slice{mid.data(), mid.size()}, /*throw_notfound=*/false)};
+        if (!data) continue;
+        auto key{to_key_bytes(data.key)};
+        if (!key_less(lo, key) || !key_less(key, hi)) continue;
+        samples.push_back(key);
+        ranges.emplace_back(std::move(lo), key);
+        ranges.emplace_back(std::move(key), std::move(hi));
+    }
+    std::ranges::sort(samples, key_less);
+
+    const auto map{cursor.map()};
+    std::vector<double> weights(samples.size() - 1);
+    double total_weight{0};
+    for (size_t i{0}; i < weights.size(); ++i) {
+        const auto distance{txn->estimate(map, Slice{samples[i].data(), samples[i].size()},
+                                          Slice{samples[i + 1].data(), samples[i + 1].size()})};
+        weights[i] = static_cast<double>(std::max<ptrdiff_t>(distance, 0) + 1);
+        total_weight += weights[i];
+    }
+
+    std::vector<std::vector<std::byte>> cuts;
+    double accumulated{0};
+    size_t quota{1};
+    for (size_t i{0}; i < weights.size() && quota < partitions; ++i) {
+        accumulated += weights[i];
+        if (accumulated < total_weight * static_cast<double>(quota) / static_cast<double>(partitions)) continue;
+        cuts.push_back(samples[i + 1]);
+        while (quota < partitions &&
+               accumulated >= total_weight * static_cast<double>(quota) / static_cast<double>(partitions)) {
+            ++quota;
+        }
+    }
+    return cuts;
+}
+
+size_t parallel_for_each(ROTxn& txn, const MapConfig& config, WalkFuncRef walker, size_t threads) {
+    // Partitioning relies on byte order of keys
+    if (threads <= 1 || config.key_mode != ::mdbx::key_mode::usual || config.key_comparator != nullptr) {
+        PooledCursor cursor{txn, config};
+        return cursor_for_each(cursor, walker);
+    }
+
+    const auto cuts{partition_key_space(txn, config, threads * kPartitionsPerThread)};
+    const size_t partitions{cuts.size() + 1};
+
+    std::atomic<size_t> next_partition{0};
+    std::atomic<size_t> total{0};
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    auto scan_partitions = [&](ROTxn& scan_txn) {
+        try {
+            PooledCursor cursor{scan_txn, config};
+            size_t count{0};
+            for (size_t p{next_partition.fetch_add(1)}; p < partitions && !failed; p = next_partition.fetch_add(1)) {
+                auto data{p == 0 ? cursor.to_first(/*throw_notfound=*/false)
+                                 : cursor.lower_bound(Slice{cuts[p - 1].data(), cuts[p - 1].size()}, false)};
+                while (data) {
+                    const ByteView key{from_slice(data.key)};
+                    if (p < cuts.size() && !key_less(key, cuts[p])) break;
+                    ++count;
+                    walker(key, from_slice(data.value));
+                    data = cursor.to_next(/*throw_notfound=*/false);
+                }
+            }
+            total += count;
+        } catch (...) {
+            std::lock_guard lock{error_mutex};
+            if (!error) error = std::current_exception();
+            failed = true;
+        }
+    };
+
+    {
+        const uint64_t snapshot{txn->id()};
+        std::vector<std::jthread> workers;
+        workers.reserve(threads - 1);
+        for (size_t i{1}; i < threads; ++i) {
+            workers.emplace_back([&, env = txn.db()]() mutable {
+                std::optional<ROTxnManaged> worker_txn;
+                try {
+                    worker_txn.emplace(env);
+                } catch (const std::exception&) {
+                    return;  // e.g. out of reader slots: the other workers take over
+                }
+                // A later snapshot would mix in newer data, so leave the partitions to the calling thread. This is
+                // always the case when the calling transaction is a write one
+                if ((*worker_txn)->id() != snapshot) return;
+                scan_partitions(*worker_txn);
+            });
+        }
+        scan_partitions(txn);
+    }  // workers are joined on destruction
+
+    if (error) std::rethrow_exception(error);
+    return total;
+}
+
+size_t cursor_for_each_block(ROTxn& txn, const MapConfig& config, std::span<ByteView> keys,
+                             std::span<ByteView> values, BlockWalkFuncRef walker) {
+    if (keys.empty() || keys.size() != values.size()) {
+        throw std::invalid_argument("Invalid argument : keys and values buffers must have the same non-zero size");
+    }
+    const size_t capacity{keys.size()};
+    size_t filled{0};
+    size_t total{0};
+    auto append = [&](ByteView key, ByteView value) {
+        keys[filled] = key;
+        values[filled] = value;
+        if (++filled == capacity) {
+            walker(keys, values);
+            total += filled;
+            filled = 0;
+        }
+    };
+
+    if (config.value_mode == ::mdbx::value_mode::single) {
+        FastCursor<> cursor{txn, config};
+        for (auto data{cursor.to_first(/*throw_notfound=*/false)}; data; data = cursor.to_next(false)) {
+            append(from_slice(data.key), from_slice(data.value));
+        }
+    } else if (!(static_cast<unsigned>(config.value_mode) & MDBX_DUPFIXED)) {
+        FastCursorDupSort cursor{txn, config};
+        for (auto data{cursor.to_first(/*throw_notfound=*/false)}; data; data = cursor.to_next(false)) {
+            append(from_slice(data.key), from_slice(data.value));
+        }
+    } else {
+        // Same-length values: fetch up to a page of values per call and slice them into the block
+        FastCursorDupSort cursor{txn, config};
+        auto data{cursor.to_first(/*throw_notfound=*/false)};
+        const size_t value_size{data ? data.value.size() : 0};
+        while (data && value_size) {
+            const ByteView key{from_slice(data.key)};
+            for (auto batch{cursor.move(MoveOperation::batch_samelength, false)}; batch;
+                 batch = cursor.move(MoveOperation::batch_samelength_next, false)) {
+                const ByteView batch_key{batch.key.data() ? from_slice(batch.key) : key};
+                const std::byte* item{static_cast<const std::byte*>(batch.value.data())};
+                for (size_t n{batch.value.size() / value_size}; n > 0; --n, item += value_size) {
+                    append(batch_key, ByteView{item, value_size});
+                }
+            }
+            data = cursor.move(MoveOperation::multi_nextkey_firstvalue, false);
+        }
+    }
+
+    if (filled) {
+        walker(keys.first(filled), values.first(filled));
+        total += filled;
+    }
+    return total;
+}
+
 size_t cursor_erase_prefix(RWCursor& cursor, const ByteView prefix) {
     size_t ret{0};
     Slice prefix_slice{prefix.data(), prefix.size()};
     auto data{cursor.lower_bound(prefix_slice, /*throw_notfound=*/false)};
     while (data) {
-        if (!data.key.starts_with(prefix_slice)) {
+        if (!utils::starts_with(from_slice(data.key), prefix)) {
             break;
         }
         ++ret;
@@ -3,13 +3,15 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <string>
 #include <span>
 #include <vector>
-#include <mutex>
 #include <unistd.h>  // for sysconf
 
 #pragma GCC diagnostic push
@@ -46,41 +48,153 @@ public:
     }
 };
 
+// Default recycler of pooled objects: nothing to reset before sharing them with other threads
+// A recycler returns false when it could not reset the object, which is then destroyed instead of shared
+struct NoopRecycler {
+    template<typename T>
+    bool operator()(T*) const noexcept { return true; }
+};
+
 // Custom ObjectPool implementation
-template<typename T, typename Deleter>
+// Meant to be used as a thread_local instance: each thread owns a bounded freelist accessed without any
+// synchronization, backed by a bounded lock-free freelist shared by all the threads. The shared freelist absorbs the
+// overflow of the local ones, the objects released by another thread than the one which acquired them and the objects
+// left by exiting threads, objects exceeding both bounds are destroyed.
+template<typename T, typename Deleter, typename Recycler = NoopRecycler, size_t LocalCapacity = 64,
+         size_t SharedCapacity = 256>
 class ObjectPool {
-    std::vector<T*> pool_;
-    mutable std::mutex mutex_;
-
 public:
+    struct Stats {
+        uint64_t acquired{0};        // Number of acquire calls
+        uint64_t local_hits{0};      // Objects reused from the thread-local freelist
+        uint64_t shared_hits{0};     // Objects reused from the shared freelist
+        uint64_t released{0};        // Number of objects added back
+        uint64_t foreign_returns{0}; // Objects added back which had been acquired from another thread's pool
+        uint64_t shared_returns{0};  // Objects handed over to the shared freelist
+        uint64_t dropped{0};         // Objects destroyed because both freelists were full
+        uint64_t recycle_failures{0}; // Objects destroyed because the Recycler could not reset them for sharing
+
+        double reuse_rate() const {
+            return acquired ? static_cast<double>(local_hits + shared_hits) / static_cast<double>(acquired) : 0.0;
+        }
+    };
+
     T* acquire() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (pool_.empty()) {
-            return nullptr;
+        ++stats_.acquired;
+        if (local_size_ > 0) {
+            ++stats_.local_hits;
+            return local_[--local_size_];
+        }
+        if (T* obj = shared_.pop()) {
+            ++stats_.shared_hits;
+            return obj;
         }
-        T* obj = pool_.back();
-        pool_.pop_back();
-        return obj;
+        return nullptr;
     }
 
-    void add(T* obj) {
-        if (obj) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            pool_.push_back(obj);
+    //! Adds back an object acquired from the pool `origin`, kept locally only when origin is this pool
+    void add(T* obj, const ObjectPool* origin) {
+        if (!obj) return;
+        ++stats_.released;
+        if (origin != this) {
+            ++stats_.foreign_returns;
+        } else if (local_size_ < LocalCapacity) {
+            local_[local_size_++] = obj;
+            return;
         }
+        share(obj);
     }
 
     void clear() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (T* obj : pool_) {
-            Deleter{}(obj);
+        for (size_t i = 0; i < local_size_; ++i) {
+            Deleter{}(local_[i]);
         }
-        pool_.clear();
+        local_size_ = 0;
     }
 
+    //! Number of objects in the thread-local freelist
+    size_t size() const { return local_size_; }
+
+    //! Number of objects in the shared freelist
+    static size_t shared_size() { return shared_.size(); }
+
+    const Stats& stats() const { return stats_; }
+
     ~ObjectPool() {
-        clear();
+        // Hand the objects over to the other threads
+        for (size_t i = 0; i < local_size_; ++i) {
+            share(local_[i]);
+        }
+        local_size_ = 0;
+    }
+
+private:
+    // Bounded freelist made of slots claimed by CAS, popping exchanges the slot so no ABA is possible
+    class SharedFreelist {
+        std::array<std::atomic<T*>, SharedCapacity> slots_{};
+        std::atomic<size_t> size_{0};
+        std::atomic<size_t> hint_{0};
+
+    public:
+        bool push(T* obj) {
+            const size_t start = hint_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < SharedCapacity; ++i) {
+                const size_t index = (start + i) % SharedCapacity;
+                T* expected = nullptr;
+                if (slots_[index].load(std::memory_order_relaxed) == nullptr &&
+                    slots_[index].compare_exchange_strong(expected, obj, std::memory_order_release,
+                                                          std::memory_order_relaxed)) {
+                    size_.fetch_add(1, std::memory_order_relaxed);
+                    hint_.store(index, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        T* pop() {
+            if (size_.load(std::memory_order_relaxed) == 0) return nullptr;
+            const size_t start = hint_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < SharedCapacity; ++i) {
+                const size_t index = (start + SharedCapacity - i) % SharedCapacity;
+                if (slots_[index].load(std::memory_order_relaxed) == nullptr) continue;
+                if (T* obj = slots_[index].exchange(nullptr, std::memory_order_acquire)) {
+                    size_.fetch_sub(1, std::memory_order_relaxed);
+                    hint_.store(index, std::memory_order_relaxed);
+                    return obj;
+                }
+            }
+            return nullptr;
+        }
+
+        size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+        ~SharedFreelist() {
+            for (auto& slot : slots_) {
+                if (T* obj = slot.exchange(nullptr)) {
+                    Deleter{}(obj);
+                }
+            }
+        }
+    };
+
+    void share(T* obj) {
+        if (!Recycler{}(obj)) {
+            ++stats_.recycle_failures;
+            Deleter{}(obj);
+        } else if (shared_.push(obj)) {
+            ++stats_.shared_returns;
+        } else {
+            ++stats_.dropped;
+            Deleter{}(obj);
+        }
     }
+
+    static inline SharedFreelist shared_{};
+
+    std::array<T*, LocalCapacity> local_{};
+    size_t local_size_{0};
+    Stats stats_{};
 };
 
 // Custom ByteView type (equivalent to silkworm's ByteView)
@@ -142,12 +256,24 @@ namespace detail {
         void operator()(MDBX_cursor* ptr) const noexcept { mdbx_cursor_close(ptr); }
     };
 
+    struct CursorHandleRecycler {  // detaches pooled cursors from their transaction before any other thread reuses them
+        constexpr CursorHandleRecycler() noexcept = default;
+        // A cursor still bound to its transaction must not be shared: the pool closes it instead
+        bool operator()(MDBX_cursor* ptr) const noexcept { return mdbx_cursor_unbind(ptr) == MDBX_SUCCESS; }
+    };
+
     std::string dump_mdbx_result(const CursorResult& result);
     std::string slice_as_hex(const Slice& data);
+
+    //! \brief Returns a key lying halfway between the provided ones in byte order
+    //! \remarks Keys are handled as base-256 fractions so keys of different length can be split as well
+    std::vector<std::byte> key_midpoint(std::span<const std::byte> lhs, std::span<const std::byte> rhs);
 }  // namespace detail
 
 class ROTxn;
 struct MapConfig;
+template <bool kDupSort = false>
+class FastCursor;
 
 //! \brief Read-only key-value cursor for single-value tables
 class ROCursor {
@@ -270,10 +396,22 @@ struct MapConfig {
     const std::string_view name{};                                    // Name of the table (is key in MAIN_DBI)
     const ::mdbx::key_mode key_mode{::mdbx::key_mode::usual};         // Key collation order
     const ::mdbx::value_mode value_mode{::mdbx::value_mode::single};  // Data Storage Mode
+    MDBX_cmp_func* const key_comparator{nullptr};                     // Custom key comparator, nullptr for key_mode
 
     std::string name_str() const { return std::string{name}; }
 };
 
+//! \brief Key comparator for (20-byte address ‖ big-endian u64 block) composite keys
+//! \details Compares the address as big-endian 8-byte words and then the block number, which orders exactly like the
+//! default memcmp collation: maps written with it stay readable with key_mode::usual. Keys not matching the layout (e.g.
+//! bare address prefixes used as seek keys) are compared as plain byte strings.
+//! \remarks MDBX does not persist custom comparators, every MapConfig opening the map must carry it
+int compare_address20_block_keys(const MDBX_val* lhs, const MDBX_val* rhs) noexcept;
+
+//! \brief Key comparator for (32-byte hash ‖ big-endian u64 block) composite keys
+//! \details Same as compare_address20_block_keys, the hash being compared as four 8-byte words
+int compare_address32_block_keys(const MDBX_val* lhs, const MDBX_val* rhs) noexcept;
+
 //! \brief ROTxn represents a read-only transaction.
 //! It is used in function signatures to clarify that read-only access is sufficient, read-write access is not required.
 class ROTxn {
@@ -380,10 +518,13 @@ class RWTxnManaged : public RWTxn {
 
     // Only movable
     RWTxnManaged(RWTxnManaged&& source) noexcept
-        : RWTxn{managed_txn_, source.commit_disabled_}, managed_txn_{std::move(source.managed_txn_)} {}
+        : RWTxn{managed_txn_, source.commit_disabled_},
+          managed_txn_{std::move(source.managed_txn_)},
+          started_{source.started_} {}
     RWTxnManaged& operator=(RWTxnManaged&& other) noexcept {
         commit_disabled_ = other.commit_disabled_;
         managed_txn_ = std::move(other.managed_txn_);
+        started_ = other.started_;
         return *this;
     }
 
@@ -392,12 +533,19 @@ class RWTxnManaged : public RWTxn {
     void commit_and_renew() override;
     void commit_and_stop() override;
 
-    void reopen(mdbx::env& env) { managed_txn_ = env.start_write(); }
+    void reopen(mdbx::env& env) {
+        managed_txn_ = env.start_write();
+        started_ = std::chrono::steady_clock::now();
+    }
 
   protected:
     explicit RWTxnManaged(mdbx::txn_managed&& source) : RWTxn{managed_txn_}, managed_txn_{std::move(source)} {}
 
+    //! \brief Commits the transaction, recording its duration and commit latency when metrics are enabled
+    void commit_and_record();
+
     mdbx::txn_managed managed_txn_;
+    std::chrono::steady_clock::time_point started_{std::chrono::steady_clock::now()};
 };
 
 //! \brief RWTxnUnmanaged wraps an *unmanaged* read-write transaction, which means the underlying transaction
@@ -468,6 +616,18 @@ struct EnvConfig {
     bool enable_coalesce{true};                 // Enable page coalescing
     bool enable_sync_durable{true};             // Enable sync durable
     bool enable_notls{true};                    // Disable thread-local storage
+
+    // Cold start warm-up (see PageWarmer)
+    bool warmup{false};                         // Whether to warm up the page cache in background after opening
+    size_t warmup_bandwidth{256_Mebi};          // Max warm-up read rate in bytes per second (0 means unlimited)
+    size_t warmup_tree_samples{64_Kibi};        // Number of evenly spread key descents per map in the tree walk
+    uint32_t warmup_queue_depth{32};            // Max in-flight reads while prefaulting hot ranges
+
+    // Access heatmap (see HeatmapRecorder)
+    bool heatmap{false};                        // Whether to sample cursor reads into a heatmap saved next to the data file
+    uint32_t heatmap_sample_rate{128};          // Record one cursor read out of this many per thread
+    uint32_t heatmap_flush_interval{60};        // Seconds between heatmap saves
+    size_t heatmap_extent_size{256_Kibi};       // Granularity of the heatmap in bytes of data file
 };
 
 //! \brief EnvUnmanaged wraps an *unmanaged* MDBX environment, which means the underlying environment
@@ -601,11 +761,22 @@ class PooledCursor : public RWCursorDupSort, protected ::mdbx::cursor {
     bool erase(const Slice& key, bool whole_multivalue) override;
     bool erase(const Slice& key, const Slice& value) override;
 
-    //! \brief Exposes handles cache
-    static const ObjectPool<MDBX_cursor, detail::CursorHandleDeleter>& handles_cache() { return handles_pool_; }
+    using HandlesPool = ObjectPool<MDBX_cursor, detail::CursorHandleDeleter, detail::CursorHandleRecycler>;
+
+    //! \brief Exposes handles cache of the calling thread
+    static const HandlesPool& handles_cache() { return handles_pool_; }
+
+    //! \brief Returns the handle reuse statistics of the calling thread
+    static const HandlesPool::Stats& handles_stats() { return handles_pool_.stats(); }
 
   private:
-    static thread_local ObjectPool<MDBX_cursor, detail::CursorHandleDeleter> handles_pool_;
+    template <bool>
+    friend class FastCursor;
+
+    static thread_local HandlesPool handles_pool_;
+
+    //! Pool of the thread which acquired the handle, the handle goes to the shared freelist if released elsewhere
+    const HandlesPool* origin_pool_{&handles_pool_};
 };
 
 //! \brief Checks whether a provided map name exists in database
@@ -666,6 +837,59 @@ size_t cursor_for_prefix(ROCursor& cursor, ByteView prefix, WalkFuncRef walker,
 size_t cursor_for_count(ROCursor& cursor, WalkFuncRef walker, size_t max_count,
                         CursorMoveDirection direction = CursorMoveDirection::kForward);
 
+//! \brief Executes a function on each record of a map splitting the work across threads
+//! \param [in] txn : A reference to a valid transaction, which defines the snapshot being scanned
+//! \param [in] config : The configuration settings for the map to scan
+//! \param [in] walker : A reference to a function with the code to execute on records. It is invoked concurrently
+//! from several threads, in key order within each partition only
+//! \param [in] threads : Max number of threads scanning, the calling one included
+//! \return The overall number of processed records
+//! \remarks The key space is split in ranges holding about the same number of entries, which are claimed by the
+//! workers as they go. Each worker scans with its own read transaction, used only if it sees the same MVCC snapshot as
+//! txn: otherwise (e.g. on write transactions or if a commit happened meanwhile) the calling thread does the work.
+//! Maps with custom key order (non-usual key_mode or a key_comparator) are scanned by the calling thread only
+size_t parallel_for_each(ROTxn& txn, const MapConfig& config, WalkFuncRef walker, size_t threads);
+
+//! \brief Reference to a processing function invoked by cursor_for_each_block on each block of records. The i-th
+//! record of the block is made of keys[i] and values[i]
+using BlockWalkFuncRef = function_ref<void(std::span<const ByteView> keys, std::span<const ByteView> values)>;
+
+//! \brief Executes a function on each block of records of a map, in key order
+//! \param [in] txn : A reference to a valid transaction
+//! \param [in] config : The configuration settings for the map to scan
+//! \param [in] keys : The caller-provided buffer receiving the keys of each block
+//! \param [in] values : The caller-provided buffer receiving the values of each block, same size as keys
+//! \param [in] walker : A reference to a function invoked with each filled block, the last one possibly partial
+//! \return The overall number of processed records
+//! \remarks Views point into the memory map and stay valid until the end of a read-only transaction. Multi-value maps
+//! with same-length values are read up to a page of values at a time (MDBX_GET_MULTIPLE / MDBX_NEXT_MULTIPLE)
+size_t cursor_for_each_block(ROTxn& txn, const MapConfig& config, std::span<ByteView> keys,
+                             std::span<ByteView> values, BlockWalkFuncRef walker);
+
+//! \brief Reference to a processing function invoked by find_batch on each looked up key. The index is the position
+//! of the key in the input batch, the result is the one obtained by cursor find on that key
+using BatchFindFuncRef = function_ref<void(size_t index, const CursorResult& result)>;
+
+//! \brief Settings for batched point lookups
+struct BatchFindOptions {
+    size_t prefetch_distance{64};  // Max number of keys the prefetchers may run ahead of the resolving cursor
+    size_t prefetch_threads{4};    // Number of helper readers faulting in pages ahead (0 disables prefetching)
+    bool sort_keys{true};          // Whether to resolve keys in byte order so that successive descents share paths
+};
+
+//! \brief Looks up a batch of keys overlapping the page faults of the upcoming keys with the current one
+//! \param [in] txn : A reference to a valid transaction
+//! \param [in] config : The configuration settings for the map to look up
+//! \param [in] keys : The keys to find
+//! \param [in] walker : A reference to a function invoked with the index of each key and its find result
+//! \param [in] options : The prefetch settings
+//! \return The overall number of keys found
+//! \remarks Keys are resolved on the calling thread within the provided transaction. Helper threads open their own
+//! read-only transactions and position throwaway cursors on upcoming keys just to bring the touched pages into the page
+//! cache, so their results are never delivered. When sort_keys is set the walker is not invoked in input order.
+size_t find_batch(ROTxn& txn, const MapConfig& config, std::span<const ByteView> keys, BatchFindFuncRef walker,
+                  const BatchFindOptions& options = {});
+
 //! \brief Erases map records by cursor until any record is found
 //! \param [in] cursor : A reference to a cursor opened on a map
 //! \param [in] set_key : The key where to set the cursor to.
@@ -0,0 +1,192 @@
+// Copyright 2025 The Silkworm Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdexcept>
+#include <utility>
+
+#include "mdbx.hpp"
+#include "mdbx_heatmap.hpp"
+#include "../utils/simd_compare.hpp"
+
+namespace datastore::kvdb {
+
+//! \brief Non-virtual cursor meant to live on the stack of hot loops
+//! \details Shares the pooled MDBX_cursor handles of PooledCursor but is neither heap allocated nor called through the
+//! ROCursor interface, so that every operation can be inlined. Multi-value operations are only available when
+//! kDupSort is set.
+//! \tparam kDupSort : Whether the cursor is opened on a multi-value (DUPSORT) map
+template <bool kDupSort>
+class FastCursor : protected ::mdbx::cursor {
+  public:
+    FastCursor(ROTxn& txn, const MapConfig& config) : FastCursor(*txn, config) {}
+    FastCursor(::mdbx::txn& txn, const MapConfig& config) : ::mdbx::cursor{acquire_handle()} {
+        if ((config.value_mode != ::mdbx::value_mode::single) != kDupSort) {
+            release_handle();
+            throw std::invalid_argument("FastCursor: value mode of map " + config.name_str() + " does not match");
+        }
+        try {
+            bind(txn, open_map(txn, config));
+        } catch (...) {
+            release_handle();
+            throw;
+        }
+    }
+    FastCursor(ROTxn& txn, ::mdbx::map_handle map) : ::mdbx::cursor{acquire_handle()} {
+        try {
+            bind(*txn, map);
+        } catch (...) {
+            release_handle();
+            throw;
+        }
+    }
+    ~FastCursor() { release_handle(); }
+
+    FastCursor(FastCursor&& other) noexcept
+        : ::mdbx::cursor{std::exchange(other.handle_, nullptr)}, origin_pool_{other.origin_pool_} {}
+    FastCursor& operator=(FastCursor&& other) noexcept {
+        std::swap(handle_, other.handle_);
+        std::swap(origin_pool_, other.origin_pool_);
+        return *this;
+    }
+
+    FastCursor(const FastCursor&) = delete;
+    FastCursor& operator=(const FastCursor&) = delete;
+
+    ::mdbx::map_handle map() const { return ::mdbx::cursor::map(); }
+    bool eof() const { return ::mdbx::cursor::eof(); }
+    bool on_first() const { return ::mdbx::cursor::on_first(); }
+    bool on_last() const { return ::mdbx::cursor::on_last(); }
+
+    CursorResult to_first(bool throw_notfound = true) { return ::mdbx::cursor::to_first(throw_notfound); }
+    CursorResult to_last(bool throw_notfound = true) { return ::mdbx::cursor::to_last(throw_notfound); }
+    CursorResult current(bool throw_notfound = true) const { return ::mdbx::cursor::current(throw_notfound); }
+    CursorResult to_next(bool throw_notfound = true) { return sampled(::mdbx::cursor::to_next(throw_notfound)); }
+    CursorResult to_previous(bool throw_notfound = true) {
+        return sampled(::mdbx::cursor::to_previous(throw_notfound));
+    }
+    CursorResult find(const Slice& key, bool throw_notfound = true) {
+        return sampled(::mdbx::cursor::find(key, throw_notfound));
+    }
+    CursorResult lower_bound(const Slice& key, bool throw_notfound = true) {
+        return sampled(::mdbx::cursor::lower_bound(key, throw_notfound));
+    }
+    MoveResult move(MoveOperation operation, bool throw_notfound) {
+        return sampled(::mdbx::cursor::move(operation, throw_notfound));
+    }
+    bool seek(const Slice& key) { return ::mdbx::cursor::seek(key); }
+
+    CursorResult to_current_first_multi(bool throw_notfound = true)
+        requires kDupSort
+    {
+        return ::mdbx::cursor::to_current_first_multi(throw_notfound);
+    }
+    CursorResult to_current_next_multi(bool throw_notfound = true)
+        requires kDupSort
+    {
+        return sampled(::mdbx::cursor::to_current_next_multi(throw_notfound));
+    }
+    CursorResult to_current_last_multi(bool throw_notfound = true)
+        requires kDupSort
+    {
+        return ::mdbx::cursor::to_current_last_multi(throw_notfound);
+    }
+    CursorResult to_next_first_multi(bool throw_notfound = true)
+        requires kDupSort
+    {
+        return sampled(::mdbx::cursor::to_next_first_multi(throw_notfound));
+    }
+    CursorResult find_multivalue(const Slice& key, const Slice& value, bool throw_notfound = true)
+        requires kDupSort
+    {
+        return sampled(::mdbx::cursor::find_multivalue(key, value, throw_notfound));
+    }
+    CursorResult lower_bound_multivalue(const Slice& key, const Slice& value, bool throw_notfound = false)
+        requires kDupSort
+    {
+        return sampled(::mdbx::cursor::lower_bound_multivalue(key, value, throw_notfound));
+    }
+    size_t count_multivalue() const
+        requires kDupSort
+    {
+        return ::mdbx::cursor::count_multivalue();
+    }
+
+    void insert(const Slice& key, Slice value) { ::mdbx::cursor::insert(key, value); }
+    void upsert(const Slice& key, const Slice& value) { ::mdbx::cursor::upsert(key, value); }
+    void update(const Slice& key, const Slice& value) { ::mdbx::cursor::update(key, value); }
+    bool erase(bool whole_multivalue = false) { return ::mdbx::cursor::erase(whole_multivalue); }
+    bool erase(const Slice& key, bool whole_multivalue = false) { return ::mdbx::cursor::erase(key, whole_multivalue); }
+
+  private:
+    static MDBX_cursor* acquire_handle() {
+        MDBX_cursor* handle{PooledCursor::handles_pool_.acquire()};
+        return handle ? handle : ::mdbx_cursor_create(nullptr);
+    }
+
+    void release_handle() noexcept {
+        if (handle_) {
+            PooledCursor::handles_pool_.add(std::exchange(handle_, nullptr), origin_pool_);
+        }
+    }
+
+    //! Same rebinding policy as PooledCursor::bind
+    void bind(::mdbx::txn& txn, ::mdbx::map_handle map) {
+        if (auto cm_tx{mdbx_cursor_txn(handle_)}; cm_tx && txn.id() != mdbx_txn_id(cm_tx)) {
+            ::mdbx_cursor_close(handle_);
+            handle_ = ::mdbx_cursor_create(nullptr);
+            origin_pool_ = &PooledCursor::handles_pool_;
+        }
+        ::mdbx::cursor::bind(txn, map);
+    }
+
+    template <typename Result>
+    static Result sampled(Result result) {
+        detail::sample_heatmap(result);
+        return result;
+    }
+
+    //! Same release policy as PooledCursor: handles released on another thread go to the shared freelist
+    const PooledCursor::HandlesPool* origin_pool_{&PooledCursor::handles_pool_};
+};
+
+using FastCursorDupSort = FastCursor<true>;
+
+//! \brief Executes a function on each record reachable by the provided fast cursor
+//! \remarks Same semantics as cursor_for_each on ROCursor, the walker being inlined instead of called through WalkFuncRef
+template <bool kDupSort, typename Walker>
+size_t cursor_for_each(FastCursor<kDupSort>& cursor, Walker&& walker,
+                       CursorMoveDirection direction = CursorMoveDirection::kForward) {
+    const auto operation{direction == CursorMoveDirection::kForward ? MoveOperation::next : MoveOperation::previous};
+    size_t ret{0};
+    CursorResult data{cursor.eof() ? (direction == CursorMoveDirection::kForward ? cursor.to_first(false)
+                                                                                 : cursor.to_last(false))
+                                   : cursor.current(false)};
+    while (data) {
+        ++ret;
+        walker(from_slice(data.key), from_slice(data.value));
+        data = cursor.move(operation, /*throw_notfound=*/false);
+    }
+    return ret;
+}
+
+//! \brief Executes a function on each record reachable by the provided fast cursor whose key starts with prefix
+//! \remarks Same semantics as cursor_for_prefix on ROCursor, the walker being inlined instead of called through
+//! WalkFuncRef
+template <bool kDupSort, typename Walker>
+size_t cursor_for_prefix(FastCursor<kDupSort>& cursor, ByteView prefix, Walker&& walker,
+                         CursorMoveDirection direction = CursorMoveDirection::kForward) {
+    const auto operation{direction == CursorMoveDirection::kForward ? MoveOperation::next : MoveOperation::previous};
+    size_t ret{0};
+    const Slice prefix_slice{prefix.data(), prefix.size()};
+    auto data{cursor.lower_bound(prefix_slice, false)};
+    while (data && utils::starts_with(from_slice(data.key), prefix)) {
+        ++ret;
+        walker(from_slice(data.key), from_slice(data.value));
+        data = cursor.move(operation, /*throw_notfound=*/false);
+    }
+    return ret;
+}
+
+}  // namespace datastore::kvdb
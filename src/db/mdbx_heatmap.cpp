@@ -0,0 +1,334 @@
+// Copyright 2025 The Silkworm Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "mdbx_heatmap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace datastore::kvdb {
+
+namespace {
+
+    // File layout, in host byte order: header followed by (extent index, hits) pairs sorted by extent index
+    constexpr std::array<char, 8> kHeatmapMagic{'M', 'D', 'B', 'X', 'H', 'E', 'A', 'T'};
+    constexpr uint32_t kHeatmapVersion{1};
+
+    struct HeatmapHeader {
+        std::array<char, 8> magic{kHeatmapMagic};
+        uint32_t version{kHeatmapVersion};
+        uint32_t reserved{0};
+        uint64_t extent_size{0};
+        uint64_t entries{0};
+    };
+
+    struct HeatmapEntry {
+        uint32_t extent{0};
+        uint32_t hits{0};
+    };
+
+    //! Period of the drains of the sample buffers, flushes happen on the first drain past the flush interval
+    constexpr std::chrono::milliseconds kDrainInterval{100};
+
+    //! Addresses sampled by one thread: a ring written by that thread only and drained under the recorder mutex
+    struct SampleBuffer {
+        static constexpr size_t kCapacity{4096};
+
+        std::array<uintptr_t, kCapacity> addresses{};
+        std::atomic<size_t> head{0};       // Next slot written by the sampling thread
+        std::atomic<size_t> tail{0};       // Next slot read by the drain
+        std::atomic<bool> retired{false};  // The sampling thread has exited
+
+        void push(uintptr_t address) {
+            const size_t position{head.load(std::memory_order_relaxed)};
+            if (position - tail.load(std::memory_order_acquire) == kCapacity) return;  // Full until next drain
+            addresses[position % kCapacity] = address;
+            head.store(position + 1, std::memory_order_release);
+        }
+
+        template <typename Func>
+        void drain(Func&& func) {
+            const size_t end{head.load(std::memory_order_acquire)};
+            size_t position{tail.load(std::memory_order_relaxed)};
+            for (; position != end; ++position) {
+                func(addresses[position % kCapacity]);
+            }
+            tail.store(position, std::memory_order_release);
+        }
+    };
+
+    //! Buffers of all the sampling threads, locked once per thread on registration and by the drains
+    std::mutex sample_buffers_mutex;
+    std::vector<std::shared_ptr<SampleBuffer>> sample_buffers;
+
+    SampleBuffer& thread_sample_buffer() {
+        // The buffer outlives its thread until the next drain has emptied it
+        struct Owner {
+            std::shared_ptr<SampleBuffer> buffer{std::make_shared<SampleBuffer>()};
+            Owner() {
+                std::lock_guard lock{sample_buffers_mutex};
+                sample_buffers.push_back(buffer);
+            }
+            ~Owner() { buffer->retired.store(true, std::memory_order_release); }
+        };
+        thread_local Owner owner;
+        return *owner.buffer;
+    }
+
+    std::atomic<HeatmapRecorder*> installed_recorder{nullptr};
+
+    uintptr_t parse_hex(std::string_view text) {
+        uintptr_t value{0};
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+        if (ec != std::errc{}) {
+            throw std::runtime_error("Invalid hex value in /proc/self/maps: " + std::string{text});
+        }
+        return value;
+    }
+
+}  // namespace
+
+AccessHeatmap::AccessHeatmap(size_t extent_size) : extent_size_{extent_size} {
+    if (extent_size_ == 0) {
+        throw std::invalid_argument("Invalid argument : extent_size");
+    }
+}
+
+void AccessHeatmap::record(uint64_t offset, uint32_t hits) {
+    auto& count{hits_[static_cast<uint32_t>(offset / extent_size_)]};
+    count = (count > UINT32_MAX - hits) ? UINT32_MAX : count + hits;
+}
+
+uint32_t AccessHeatmap::hits(uint64_t offset) const {
+    const auto it{hits_.find(static_cast<uint32_t>(offset / extent_size_))};
+    return it != hits_.end() ? it->second : 0;
+}
+
+void AccessHeatmap::decay() {
+    for (auto it{hits_.begin()}; it != hits_.end();) {
+        it->second /= 2;
+        it = it->second == 0 ? hits_.erase(it) : std::next(it);
+    }
+}
+
+std::vector<WarmupRange> AccessHeatmap::hot_ranges() const {
+    std::vector<std::pair<uint32_t, uint32_t>> extents{hits_.begin(), hits_.end()};
+    std::ranges::sort(extents, [](const auto& lhs, const auto& rhs) {
+        return lhs.second != rhs.second ? lhs.second > rhs.second : lhs.first < rhs.first;
+    });
+    std::vector<WarmupRange> ranges;
+    ranges.reserve(extents.size());
+    for (const auto& [extent, _] : extents) {
+        ranges.push_back({.offset = static_cast<uint64_t>(extent) * extent_size_, .length = extent_size_});
+    }
+    return ranges;
+}
+
+void AccessHeatmap::save(const std::filesystem::path& file) const {
+    std::vector<HeatmapEntry> entries;
+    entries.reserve(hits_.size());
+    for (const auto& [extent, hits] : hits_) {
+        entries.push_back({extent, hits});
+    }
+    std::ranges::sort(entries, {}, &HeatmapEntry::extent);
+
+    const HeatmapHeader header{.extent_size = extent_size_, .entries = entries.size()};
+    auto temp_file{file};
+    temp_file += ".tmp";
+    {
+        std::ofstream out{temp_file, std::ios::binary | std::ios::trunc};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()),
+                  static_cast<std::streamsize>(entries.size() * sizeof(HeatmapEntry)));
+        if (!out.flush()) {
+            throw std::runtime_error("Unable to write " + temp_file.string());
+        }
+    }
+    std::filesystem::rename(temp_file, file);
+}
+
+std::optional<AccessHeatmap> AccessHeatmap::load(const std::filesystem::path& file) {
+    std::ifstream in{file, std::ios::binary};
+    if (!in) return std::nullopt;
+
+    HeatmapHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kHeatmapMagic ||
+        header.version != kHeatmapVersion || header.extent_size == 0) {
+        throw std::runtime_error("Invalid heatmap file " + file.string());
+    }
+    AccessHeatmap heatmap{header.extent_size};
+    HeatmapEntry entry;
+    for (uint64_t i{0}; i < header.entries; ++i) {
+        if (!in.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+            throw std::runtime_error("Truncated heatmap file " + file.string());
+        }
+        heatmap.hits_[entry.extent] = entry.hits;
+    }
+    return heatmap;
+}
+
+namespace detail {
+    std::atomic<uint32_t> heatmap_sample_rate{0};
+
+    void record_heatmap_sample(const CursorResult& result) {
+        if (!result.done) return;
+        // Value data lives in the leaf (or large) page the cursor is positioned on
+        const void* address{result.value ? result.value.data() : result.key.data()};
+        if (!address) return;
+        thread_sample_buffer().push(reinterpret_cast<uintptr_t>(address));
+    }
+}  // namespace detail
+
+HeatmapRecorder::HeatmapRecorder(const EnvConfig& config)
+    : data_file_{get_datafile_path(config.path)},
+      heatmap_file_{get_heatmap_path(config.path)},
+      flush_interval_(std::max<uint32_t>(config.heatmap_flush_interval, 1)),
+      heatmap_{config.heatmap_extent_size} {
+    // Keep what previous sessions have learnt, weighing less than the new samples
+    try {
+        if (auto previous{AccessHeatmap::load(heatmap_file_)}; previous && previous->extent_size() == heatmap_.extent_size()) {
+            heatmap_ = std::move(*previous);
+            heatmap_.decay();
+        }
+    } catch (const std::runtime_error&) {
+        // A corrupted heatmap is simply rebuilt from scratch
+    }
+    resolve_mapping();
+
+    HeatmapRecorder* expected{nullptr};
+    if (!installed_recorder.compare_exchange_strong(expected, this)) {
+        throw std::logic_error("HeatmapRecorder: another recorder is already installed");
+    }
+    // Samples left over by a previous recorder may belong to another mapping
+    {
+        std::lock_guard lock{sample_buffers_mutex};
+        for (const auto& buffer : sample_buffers) {
+            buffer->drain([](uintptr_t) {});
+        }
+    }
+    detail::heatmap_sample_rate = std::max<uint32_t>(config.heatmap_sample_rate, 1);
+    thread_ = std::jthread{[this](std::stop_token stop) { run(stop); }};
+}
+
+HeatmapRecorder::~HeatmapRecorder() {
+    detail::heatmap_sample_rate = 0;
+    thread_.request_stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    installed_recorder = nullptr;
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // Losing the last samples only makes the next warm-up less accurate
+    }
+}
+
+void HeatmapRecorder::flush() {
+    const AccessHeatmap heatmap{snapshot()};
+    heatmap.save(heatmap_file_);
+}
+
+AccessHeatmap HeatmapRecorder::snapshot() {
+    drain();
+    std::lock_guard lock{mutex_};
+    return heatmap_;
+}
+
+size_t HeatmapRecorder::samples() {
+    drain();
+    std::lock_guard lock{mutex_};
+    return samples_;
+}
+
+void HeatmapRecorder::drain() {
+    std::lock_guard lock{mutex_};
+    std::lock_guard buffers_lock{sample_buffers_mutex};
+    std::erase_if(sample_buffers, [this](const std::shared_ptr<SampleBuffer>& buffer) {
+        // Read the flag first: once retired, the buffer gets no more samples after this drain
+        const bool retired{buffer->retired.load(std::memory_order_acquire)};
+        buffer->drain([this](uintptr_t address) { record(address); });
+        return retired;
+    });
+}
+
+void HeatmapRecorder::record(uintptr_t address) {
+    if (address < map_begin_ || address >= map_end_) {
+        // Either dirty pages of a write transaction or the map has been moved by a geometry change
+        ++misses_;
+        return;
+    }
+    heatmap_.record(address - map_begin_);
+    ++samples_;
+}
+
+void HeatmapRecorder::resolve_mapping() {
+    std::error_code ec;
+    const auto target{std::filesystem::canonical(data_file_, ec)};
+    if (ec) return;
+
+    uintptr_t begin{0};
+    uintptr_t end{0};
+    std::ifstream maps{"/proc/self/maps"};
+    std::string line;
+    while (std::getline(maps, line)) {
+        // Format: begin-end perms offset dev inode pathname
+        std::istringstream fields{line};
+        std::string range, perms, offset, device, inode, pathname;
+        fields >> range >> perms >> offset >> device >> inode;
+        std::getline(fields >> std::ws, pathname);
+        if (pathname != target.native()) continue;
+
+        const auto dash{range.find('-')};
+        const uintptr_t segment_begin{parse_hex(std::string_view{range}.substr(0, dash))};
+        const uintptr_t segment_end{parse_hex(std::string_view{range}.substr(dash + 1))};
+        if (parse_hex(offset) == 0 && begin == 0) {
+            begin = segment_begin;
+            end = segment_end;
+        } else if (begin != 0 && segment_begin == end) {
+            end = segment_end;  // Same mapping split by different protections
+        }
+    }
+
+    std::lock_guard lock{mutex_};
+    map_begin_ = begin;
+    map_end_ = end;
+    misses_ = 0;
+}
+
+void HeatmapRecorder::run(const std::stop_token& stop) {
+    auto next_flush{std::chrono::steady_clock::now() + flush_interval_};
+    while (!stop.stop_requested()) {
+        {
+            std::unique_lock lock{flush_mutex_};
+            if (cv_.wait_for(lock, stop, kDrainInterval, [] { return false; }); stop.stop_requested()) break;
+        }
+        drain();
+        if (std::chrono::steady_clock::now() < next_flush) continue;
+        next_flush = std::chrono::steady_clock::now() + flush_interval_;
+        try {
+            bool remap{false};
+            {
+                std::lock_guard lock{mutex_};
+                remap = misses_ > samples_ / 16;
+            }
+            if (remap) resolve_mapping();
+            flush();
+        } catch (const std::exception&) {
+            // Retry on next period
+        }
+    }
+}
+
+std::unique_ptr<HeatmapRecorder> start_heatmap_recorder(const EnvConfig& config) {
+    if (!config.heatmap) return nullptr;
+    return std::make_unique<HeatmapRecorder>(config);
+}
+
+}  // namespace datastore::kvdb
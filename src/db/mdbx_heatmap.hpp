@@ -0,0 +1,139 @@
+// Copyright 2025 The Silkworm Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "mdbx.hpp"
+#include "mdbx_warmer.hpp"
+
+namespace datastore::kvdb {
+
+inline constexpr std::string_view kDbHeatmapFileName{"mdbx.heat"};
+
+//! \brief Builds the full path to the access heatmap file provided a directory
+//! \param [in] base_path : a reference to the directory holding the data file
+//! \return A path with file name
+inline std::filesystem::path get_heatmap_path(const std::filesystem::path& base_path) noexcept {
+    return std::filesystem::path(base_path / std::filesystem::path(kDbHeatmapFileName));
+}
+
+//! \brief Access counts of the fixed-size extents of the data file
+class AccessHeatmap {
+  public:
+    explicit AccessHeatmap(size_t extent_size);
+
+    size_t extent_size() const { return extent_size_; }
+
+    //! \brief Number of extents having been accessed
+    size_t size() const { return hits_.size(); }
+
+    //! \brief Adds hits to the extent containing the provided data file offset
+    void record(uint64_t offset, uint32_t hits = 1);
+
+    //! \brief Returns the hits of the extent containing the provided data file offset
+    uint32_t hits(uint64_t offset) const;
+
+    //! \brief Halves all counts dropping the extents which become cold, so that older sessions weigh less
+    void decay();
+
+    //! \brief Returns the accessed extents as data file ranges, hottest first
+    std::vector<WarmupRange> hot_ranges() const;
+
+    //! \brief Persists the heatmap replacing the provided file atomically
+    void save(const std::filesystem::path& file) const;
+
+    //! \brief Loads a heatmap saved by save()
+    //! \return The heatmap or std::nullopt when the file does not exist
+    //! \throws std::runtime_error when the file is not a valid heatmap
+    static std::optional<AccessHeatmap> load(const std::filesystem::path& file);
+
+  private:
+    size_t extent_size_;
+    std::unordered_map<uint32_t, uint32_t> hits_;  // Extent index -> hits
+};
+
+namespace detail {
+    //! Sampling period of the installed HeatmapRecorder, zero when none is installed
+    extern std::atomic<uint32_t> heatmap_sample_rate;
+
+    //! \brief Appends the page of the result to the sample buffer of the calling thread, without locking
+    void record_heatmap_sample(const CursorResult& result);
+
+    //! \brief Feeds one out of heatmap_sample_rate cursor reads of the calling thread to the installed recorder
+    inline void sample_heatmap(const CursorResult& result) {
+        const uint32_t rate{heatmap_sample_rate.load(std::memory_order_relaxed)};
+        if (rate == 0) [[likely]] return;
+        thread_local uint32_t countdown{0};
+        if (countdown > 0) {
+            --countdown;
+            return;
+        }
+        countdown = rate - 1;
+        record_heatmap_sample(result);
+    }
+}  // namespace detail
+
+//! \brief Samples the pages touched by PooledCursor reads into an AccessHeatmap saved next to the data file
+//! \details Sampled cursor positions are turned into data file offsets through the address of the returned data
+//! within the memory map. Reading threads only append the addresses to bounded per-thread buffers (samples are
+//! dropped when a buffer is full), which the recorder thread drains into the heatmap every few milliseconds. The
+//! heatmap is saved every EnvConfig::heatmap_flush_interval seconds and on destruction, the counts of the previous
+//! sessions being decayed on construction.
+//! \remarks Only one recorder may be installed per process at a time
+class HeatmapRecorder {
+  public:
+    explicit HeatmapRecorder(const EnvConfig& config);
+    ~HeatmapRecorder();
+
+    HeatmapRecorder(const HeatmapRecorder&) = delete;
+    HeatmapRecorder& operator=(const HeatmapRecorder&) = delete;
+
+    //! \brief Saves the heatmap right away
+    void flush();
+
+    //! \brief Returns a copy of the current heatmap, including the samples still buffered by the reading threads
+    AccessHeatmap snapshot();
+
+    //! \brief Number of samples recorded so far, not counting the ones outside the data file mapping
+    size_t samples();
+
+  private:
+    //! \brief Moves the buffered samples of all threads into the heatmap
+    void drain();
+    void record(uintptr_t address);  // mutex_ held
+    void resolve_mapping();
+    void run(const std::stop_token& stop);
+
+    std::filesystem::path data_file_;
+    std::filesystem::path heatmap_file_;
+    std::chrono::seconds flush_interval_;
+
+    std::mutex mutex_;  // Guards the heatmap and serializes the drains
+    AccessHeatmap heatmap_;
+    uintptr_t map_begin_{0};
+    uintptr_t map_end_{0};
+    size_t samples_{0};
+    size_t misses_{0};  // Samples outside the mapping since last resolution
+
+    std::mutex flush_mutex_;
+    std::condition_variable_any cv_;
+    std::jthread thread_;
+};
+
+//! \brief Starts a HeatmapRecorder if enabled in the environment config
+//! \return The installed recorder or nullptr when EnvConfig::heatmap is not set
+std::unique_ptr<HeatmapRecorder> start_heatmap_recorder(const EnvConfig& config);
+
+}  // namespace datastore::kvdb
@@ -1,10 +1,18 @@
 #include "db/mdbx_impl.hpp"
-#include "utils/endian.hpp"
+#include "db/db_metrics.hpp"
+#include "db/mdbx.hpp"
+#include "utils/composite_key.hpp"
+#include "utils/history_chunk.hpp"
+#include "utils/simd_compare.hpp"
 
 #include <fmt/core.h>
 #include <mdbx.h++>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <string>
 #include <stdexcept>
 #include <vector>
 #include <cstdint>
@@ -14,10 +22,209 @@
 struct MdbxImpl::MdbxPimpl {
     mdbx::env_managed env;
     mdbx::map_handle dbi;
+    MdbxLayout layout{MdbxLayout::kVersionPerKey};
+    std::string map_name;
+
+    // Value compression, null for uncompressed tables
+    std::unique_ptr<ValueCodec> codec;
+    std::unique_ptr<HotValueCache> cache;
+    mdbx::map_handle dictionary_dbi;  // Table name -> zstd dictionary of the table
+    std::atomic<bool> dictionary_saved{false};
+
+    // Writes the trained zstd dictionary in the same transaction as the first values compressed with it,
+    // so that it is committed if and only if they are.
+    auto stage_dictionary(mdbx::txn& txn) -> bool {
+        if (!codec || dictionary_saved.load() || codec->dictionary().empty()) {
+            return false;
+        }
+        const auto dictionary = codec->dictionary();
+        txn.upsert(dictionary_dbi, mdbx::slice{map_name}, mdbx::slice{dictionary.data(), dictionary.size()});
+        return true;
+    }
+};
+
+namespace {
+
+auto as_bytes(const mdbx::slice& slice) -> std::span<const std::byte> {
+    return {static_cast<const std::byte*>(slice.data()), slice.size()};
+}
+
+auto db_metrics() -> const DbMetrics& {
+    static const DbMetrics metrics{"mdbx"};
+    return metrics;
+}
+
+void count_hot_cache_lookup(bool hit) {
+    if (!utils::metrics_enabled()) {
+        return;
+    }
+    static utils::Counter& hits = DbMetrics::cache("mdbx", "hot_values", /*hit=*/true);
+    static utils::Counter& misses = DbMetrics::cache("mdbx", "hot_values", /*hit=*/false);
+    (hit ? hits : misses).add();
+}
+
+// --- Value compression ---
+// The bytes of a value: the database page itself, or the decompressed copy the span points into
+struct LoadedValue {
+    std::span<const std::byte> bytes;
+    HotValueCache::Value decoded;
+};
+
+auto load_value(const ValueCodec* codec, HotValueCache* cache, const mdbx::slice& key, const mdbx::slice& stored)
+    -> LoadedValue {
+    if (codec == nullptr) {
+        return {as_bytes(stored), nullptr};
+    }
+    if (cache != nullptr) {
+        auto hit = cache->find(as_bytes(key), as_bytes(stored));
+        count_hot_cache_lookup(hit != nullptr);
+        if (hit) {
+            return {*hit, hit};
+        }
+    }
+    auto decoded = std::make_shared<const std::vector<std::byte>>(codec->decode(as_bytes(stored)));
+    if (cache != nullptr) {
+        cache->insert(as_bytes(key), as_bytes(stored), decoded);
+    }
+    return {*decoded, decoded};
+}
+
+void store_value(mdbx::cursor& cursor, ValueCodec* codec, const mdbx::slice& key, std::span<const std::byte> value) {
+    if (codec == nullptr) {
+        cursor.upsert(key, {value.data(), value.size()});
+        return;
+    }
+    const auto stored = codec->encode(value);
+    cursor.upsert(key, {stored.data(), stored.size()});
+}
+
+// --- History chunk layout ---
+// Each chunk is keyed by `len(account) + account + big_endian(last block of the chunk)`, the newest chunk of an account
+// being keyed by kOpenChunk so that appending never re-keys it. The length prefix keeps the chunks of an account
+// contiguous even when its name is a prefix of another account name, so a lower_bound on (account, block) always
+// lands on the chunk covering block.
+constexpr uint64_t kOpenChunk = UINT64_MAX;
+
+class ChunkKey {
+public:
+    ChunkKey(std::span<const std::byte> account, uint64_t block_number) {
+        if (account.size() > utils::kMaxAccountNameLength) {
+            throw std::length_error("MDBX history chunk: account name longer than kMaxAccountNameLength");
+        }
+        buffer_[0] = static_cast<std::byte>(account.size());
+        std::ranges::copy(account, buffer_.begin() + 1);
+        size_ = 1 + account.size() + sizeof(uint64_t);
+        set_block_number(block_number);
+    }
+
+    void set_block_number(uint64_t block_number) {
+        utils::BlockBE64::encode(buffer_.data() + size_ - sizeof(uint64_t), block_number);
+    }
+
+    auto slice() const -> mdbx::slice { return {buffer_.data(), size_}; }
+
+    // Whether key is a chunk key of the same account
+    auto same_account(const mdbx::slice& key) const -> bool {
+        const auto prefix = std::span<const std::byte>{buffer_.data(), size_ - sizeof(uint64_t)};
+        return key.size() == size_ && utils::starts_with(as_bytes(key), prefix);
+    }
+
+    static auto block_number(const mdbx::slice& key) -> uint64_t {
+        return utils::BlockBE64::decode(as_bytes(key).last<sizeof(uint64_t)>().data());
+    }
+
+private:
+    std::array<std::byte, 1 + utils::kMaxAccountNameLength + sizeof(uint64_t)> buffer_{};
+    size_t size_ = 0;
 };
 
+void upsert_history(mdbx::cursor& cursor, ValueCodec* codec, std::span<const std::byte> account, uint64_t block_number,
+                    std::span<const std::byte> value) {
+    ChunkKey key{account, block_number};
+    std::vector<utils::HistoryEntry> entries;
+    LoadedValue chunk;
+    uint64_t chunk_block = kOpenChunk;
+    if (auto found = cursor.lower_bound(key.slice(), /*throw_notfound=*/false); found.done && key.same_account(found.key)) {
+        chunk_block = ChunkKey::block_number(found.key);
+        chunk = load_value(codec, nullptr, found.key, found.value);
+        entries = utils::HistoryChunkView{chunk.bytes}.entries();
+    }
+    utils::upsert_history_entry(entries, {block_number, value});
+
+    // Entries point into the database pages: encode everything before the first put modifies them
+    if (entries.size() <= utils::kMaxHistoryChunkEntries) {
+        const auto encoded = utils::encode_history_chunk(entries);
+        key.set_block_number(chunk_block);
+        store_value(cursor, codec, key.slice(), encoded);
+        return;
+    }
+    // Full chunk: the lower half becomes a closed chunk keyed by its last block, the upper half keeps the chunk key
+    const auto half = std::span{entries}.first(entries.size() / 2);
+    const auto rest = std::span{entries}.subspan(half.size());
+    const auto lower = utils::encode_history_chunk(half);
+    const auto upper = utils::encode_history_chunk(rest);
+    key.set_block_number(half.back().block_number);
+    store_value(cursor, codec, key.slice(), lower);
+    key.set_block_number(chunk_block);
+    store_value(cursor, codec, key.slice(), upper);
+}
+
+auto find_history(mdbx::cursor& cursor, const ValueCodec* codec, HotValueCache* cache, std::string_view account_name,
+                  uint64_t block_number) -> std::optional<std::vector<std::byte>> {
+    const ChunkKey key{std::as_bytes(std::span{account_name.data(), account_name.size()}), block_number};
+
+    // The first chunk whose last block is >= block_number holds the answer, unless all its versions are newer
+    auto result = cursor.lower_bound(key.slice(), /*throw_notfound=*/false);
+    if (!result.done || !key.same_account(result.key)) {
+        return std::nullopt;
+    }
+    const auto chunk = load_value(codec, cache, result.key, result.value);
+    if (const auto entry = utils::HistoryChunkView{chunk.bytes}.find_less_equal(block_number)) {
+        return std::vector<std::byte>{entry->value.begin(), entry->value.end()};
+    }
+
+    // Then it is the last version of the previous chunk, whose last block is < block_number
+    result = cursor.to_previous(/*throw_notfound=*/false);
+    if (!result.done || !key.same_account(result.key)) {
+        return std::nullopt;
+    }
+    const auto previous = load_value(codec, cache, result.key, result.value);
+    const auto entry = utils::HistoryChunkView{previous.bytes}.last();
+    return std::vector<std::byte>{entry.value.begin(), entry.value.end()};
+}
+
+void upsert(mdbx::cursor& cursor, MdbxLayout layout, ValueCodec* codec, std::span<const std::byte> key,
+            std::span<const std::byte> value) {
+    utils::CompositeKey::check_length(key);
+    if (layout == MdbxLayout::kVersionPerKey) {
+        store_value(cursor, codec, {key.data(), key.size()}, value);
+        return;
+    }
+    if (key.size() < sizeof(uint64_t)) {
+        throw std::invalid_argument("MDBX history chunk: key shorter than a block number");
+    }
+    const auto account = key.first(key.size() - sizeof(uint64_t));
+    upsert_history(cursor, codec, account, utils::BlockBE64::decode(account.data() + account.size()), value);
+}
+
+} // namespace
+
 // --- Constructor & Destructor ---
-MdbxImpl::MdbxImpl(const std::filesystem::path& db_path) : pimpl_{std::make_unique<MdbxPimpl>()} {
+MdbxImpl::MdbxImpl(const std::filesystem::path& db_path, MdbxLayout layout)
+    : MdbxImpl(db_path, MdbxOptions{.layout = layout}) {}
+
+MdbxImpl::MdbxImpl(const std::filesystem::path& db_path, const MdbxOptions& options)
+    : pimpl_{std::make_unique<MdbxPimpl>()} {
+    pimpl_->layout = options.layout;
+    pimpl_->map_name = options.layout == MdbxLayout::kHistoryChunks ? "AccountHistory" : "AccountState";
+    if (options.values.compression != ValueCompression::kNone) {
+        // Compressed values carry a header byte: keep them apart from the tables of uncompressed values
+        pimpl_->map_name += ".z";
+        pimpl_->codec = std::make_unique<ValueCodec>(options.values);
+        if (options.hot_cache_entries > 0) {
+            pimpl_->cache = std::make_unique<HotValueCache>(options.hot_cache_entries);
+        }
+    }
     try {
         if (!std::filesystem::exists(db_path)) {
             std::filesystem::create_directories(db_path);
@@ -35,7 +242,15 @@ MdbxImpl::MdbxImpl(const std::filesystem::path& db_path) : pimpl_{std::make_uniq
         pimpl_->env = mdbx::env_managed(db_path.string(), create_params, operate_params);
 
         auto txn = pimpl_->env.start_write();
-        pimpl_->dbi = txn.create_map("AccountState", mdbx::key_mode::usual, mdbx::value_mode::single);
+        pimpl_->dbi = txn.create_map(pimpl_->map_name, mdbx::key_mode::usual, mdbx::value_mode::single);
+        if (pimpl_->codec) {
+            pimpl_->dictionary_dbi = txn.create_map("ValueDictionary", mdbx::key_mode::usual, mdbx::value_mode::single);
+            const auto dictionary = txn.get(pimpl_->dictionary_dbi, mdbx::slice{pimpl_->map_name}, mdbx::slice{});
+            if (!dictionary.empty()) {
+                pimpl_->codec->load_dictionary(as_bytes(dictionary));
+                pimpl_->dictionary_saved = true;
+            }
+        }
         txn.commit();
 
         fmt::print("MDBX database opened successfully at: {}\n", db_path.string());
@@ -48,34 +263,87 @@ MdbxImpl::~MdbxImpl() = default; // Needed for the unique_ptr to a forward-decla
 
 // --- Public Methods ---
 void MdbxImpl::put(std::span<const std::byte> key, std::span<const std::byte> value) {
+    const auto& metrics = db_metrics();
+    const utils::ScopedLatency latency{metrics.put.latency};
     auto txn = pimpl_->env.start_write();
     auto cursor = txn.open_cursor(pimpl_->dbi);
-    cursor.upsert({key.data(), key.size()}, {value.data(), value.size()});
+    upsert(cursor, pimpl_->layout, pimpl_->codec.get(), key, value);
+    cursor.close();
+    const bool dictionary_staged = pimpl_->stage_dictionary(txn);
     txn.commit();
+    if (dictionary_staged) {
+        pimpl_->dictionary_saved = true;
+    }
+    metrics.count(metrics.put, 0, key.size() + value.size());
+}
+
+void MdbxImpl::write(WriteBatch&& batch, Durability durability) {
+    if (batch.empty()) {
+        return;
+    }
+
+    const auto& metrics = db_metrics();
+    const utils::ScopedLatency latency{metrics.write.latency};
+
+    // Sorted keys make consecutive upserts land on the same or neighbouring leaf pages
+    batch.sort_by_key();
+
+    // env::start_write() takes no flags: begin through the C API to allow relaxing durability per transaction
+    const MDBX_txn_flags_t flags =
+        durability == Durability::kSync ? MDBX_TXN_READWRITE : MDBX_TXN_READWRITE | MDBX_TXN_NOSYNC;
+    MDBX_txn* handle = nullptr;
+    bool dictionary_staged = false;
+    mdbx::error::success_or_throw(::mdbx_txn_begin(pimpl_->env, nullptr, flags, &handle));
+
+    try {
+        // Commit and abort stay with this function, which owns the handle
+        datastore::kvdb::RWTxnUnmanaged txn{handle};
+        auto cursor = txn->open_cursor(pimpl_->dbi);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const auto [key, value] = batch[i];
+            upsert(cursor, pimpl_->layout, pimpl_->codec.get(), key, value);
+        }
+        cursor.close();
+        dictionary_staged = pimpl_->stage_dictionary(*txn);
+    } catch (...) {
+        ::mdbx_txn_abort(handle);
+        throw;
+    }
+    mdbx::error::success_or_throw(::mdbx_txn_commit(handle));
+    if (dictionary_staged) {
+        pimpl_->dictionary_saved = true;
+    }
+    metrics.count(metrics.write, 0, batch.byte_size());
 }
 
 auto MdbxImpl::get_state(std::string_view account_name, uint64_t block_number)
     -> std::optional<std::vector<std::byte>> {
+    const auto& metrics = db_metrics();
+    const utils::ScopedLatency latency{metrics.get_state.latency};
+    auto counted = [&](std::optional<std::vector<std::byte>> state) {
+        metrics.count(metrics.get_state, state ? state->size() : 0, 0);
+        return state;
+    };
+    if (!utils::CompositeKey::fits(account_name)) {
+        return counted(std::nullopt);  // Never stored, writes reject such names
+    }
+
     auto txn = pimpl_->env.start_read();
     auto cursor = txn.open_cursor(pimpl_->dbi);
 
-    // 1. Construct the seek key: account_name + big_endian(block_number + 1)
-    std::vector<std::byte> seek_key;
-    seek_key.reserve(account_name.length() + sizeof(uint64_t));
-    seek_key.insert(seek_key.end(),
-                    reinterpret_cast<const std::byte*>(account_name.data()),
-                    reinterpret_cast<const std::byte*>(account_name.data()) + account_name.length());
+    if (pimpl_->layout == MdbxLayout::kHistoryChunks) {
+        return counted(find_history(cursor, pimpl_->codec.get(), pimpl_->cache.get(), account_name, block_number));
+    }
 
-    const auto be_block = utils::to_big_endian_bytes(block_number + 1);
-    seek_key.insert(seek_key.end(), be_block.begin(), be_block.end());
+    // 1. Construct the seek key on the stack: account_name + big_endian(block_number + 1)
+    const utils::CompositeKey seek_key{account_name, block_number + 1};
 
     // 2. Find the lower bound, i.e., the first key >= seek_key.
     auto result = cursor.lower_bound({seek_key.data(), seek_key.size()}, /*throw_notfound=*/false);
 
     // 3. Move to the previous key, which is the largest key <= our target (account, block).
-    if (!result.done) {
-        // We found a key >= seek_key, which could be for the next account.
-        // Or we are at the end. In both cases, we must step back.
+    if (result.done) {
+        // We found a key >= seek_key, which could be for the next account: step back.
         result = cursor.to_previous(/*throw_notfound=*/false);
     } else {
         // We are past the end of the database. The last key might be what we want.
@@ -84,25 +352,29 @@ auto MdbxImpl::get_state(std::string_view account_name, uint64_t block_number)
 
     if (result.done) {
         // 4. Validate that the found key belongs to the correct account.
-        std::string_view found_key_sv{reinterpret_cast<const char*>(result.key.data()), result.key.size()};
+        const std::span<const std::byte> found_key{static_cast<const std::byte*>(result.key.data()),
+                                                   result.key.size()};
+
+        if (found_key.size() >= account_name.length() + sizeof(uint64_t) &&
+            utils::starts_with(found_key, account_name)) {
 
-        if (found_key_sv.starts_with(account_name) && 
-            found_key_sv.length() >= account_name.length() + sizeof(uint64_t)) {
-            
             // 5. Extract the block number from the found key and verify it's <= requested block
-            const auto* block_bytes = reinterpret_cast<const std::byte*>(
-                found_key_sv.data() + account_name.length());
-            auto found_block = utils::from_big_endian_bytes(
-                std::span<const std::byte, 8>{block_bytes, 8});
-            
+            const auto found_block = utils::BlockBE64::decode(found_key.data() + account_name.length());
+
             if (found_block <= block_number) {
-                // 6. If it matches, return the value.
-                const auto* value_ptr = static_cast<const std::byte*>(result.value.data());
-                return std::vector<std::byte>{value_ptr, value_ptr + result.value.size()};
+                // 6. If it matches, return the value (decompressed if the table is compressed).
+                const auto value = load_value(pimpl_->codec.get(), pimpl_->cache.get(), result.key, result.value);
+                return counted(std::vector<std::byte>{value.bytes.begin(), value.bytes.end()});
             }
         }
     }
 
     // 6. If no suitable key was found, return nullopt.
-    return std::nullopt;
+    return counted(std::nullopt);
+}
+
+auto MdbxImpl::storage_bytes() const -> uint64_t {
+    auto txn = pimpl_->env.start_read();
+    const auto stat = txn.get_map_stat(pimpl_->dbi);
+    return (stat.ms_branch_pages + stat.ms_leaf_pages + stat.ms_overflow_pages) * stat.ms_psize;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "db/interface.hpp"
+#include "db/value_codec.hpp"
 
 #include <filesystem>
 #include <cstdint>
@@ -13,13 +14,34 @@ class env_managed;
 struct map_handle;
 } // namespace mdbx
 
+/**
+ * @brief How account versions are laid out in the MDBX table.
+ */
+enum class MdbxLayout {
+    kVersionPerKey,  // One `account + big_endian(block)` key per version (table "AccountState")
+    kHistoryChunks,  // Versions grouped in delta+varint encoded chunks of up to 64 (table "AccountHistory")
+};
+
+struct MdbxOptions {
+    MdbxLayout layout{MdbxLayout::kVersionPerKey};
+    ValueCodecOptions values{};   // Value compression; compressed tables are suffixed ".z" (e.g. "AccountState.z")
+    size_t hot_cache_entries{0};  // Decompressed values kept for hot keys, 0 to disable
+};
+
 class MdbxImpl final : public IDatabase {
 public:
     /**
      * @brief Constructs an MdbxImpl object and opens/creates the database at the given path.
      * @param db_path The file system path to the directory where the MDBX database is stored.
+     * @param layout The layout of the account versions, each layout using its own table.
      */
-    explicit MdbxImpl(const std::filesystem::path& db_path);
+    explicit MdbxImpl(const std::filesystem::path& db_path, MdbxLayout layout = MdbxLayout::kVersionPerKey);
+
+    /**
+     * @brief Constructs an MdbxImpl object with the given layout and value compression.
+     * @throws std::invalid_argument if the requested compression was not compiled in.
+     */
+    MdbxImpl(const std::filesystem::path& db_path, const MdbxOptions& options);
 
     ~MdbxImpl() override;
 
@@ -31,9 +53,16 @@ public:
 
     void put(std::span<const std::byte> key, std::span<const std::byte> value) override;
 
+    void write(WriteBatch&& batch, Durability durability) override;
+
     auto get_state(std::string_view account_name, uint64_t block_number)
         -> std::optional<std::vector<std::byte>> override;
 
+    /**
+     * @brief Returns the bytes of all the pages (branch, leaf and overflow) used by the account table.
+     */
+    auto storage_bytes() const -> uint64_t;
+
 private:
     // PImpl idiom to hide MDBX implementation details from the header.
     // This holds the mdbx::env_managed and mdbx::map_handle.
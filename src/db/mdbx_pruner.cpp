@@ -0,0 +1,178 @@
+// Copyright 2025 The Silkworm Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "mdbx_pruner.hpp"
+
+#include "../utils/key_schema.hpp"
+#include "../utils/simd_compare.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace datastore::kvdb {
+
+namespace {
+
+    std::vector<std::byte> to_bytes(const Slice& slice) {
+        const auto* data{static_cast<const std::byte*>(slice.data())};
+        return {data, data + slice.size()};
+    }
+
+}  // namespace
+
+PruneStepResult prune_history_step(RWTxn& txn, const MapConfig& config, uint64_t horizon, ByteView start_key,
+                                   size_t max_erased, size_t max_scanned) {
+    // Each step must get past the record it resumes on
+    max_erased = std::max<size_t>(max_erased, 1);
+    max_scanned = std::max<size_t>(max_scanned, 2);
+
+    PruneStepResult result;
+    auto cursor{txn.rw_cursor(config)};
+    auto data{start_key.empty() ? cursor->to_first(/*throw_notfound=*/false)
+                                : cursor->lower_bound(to_slice(start_key), /*throw_notfound=*/false)};
+
+    // Previous record when it is a version <= horizon, which the current record supersedes if it is a version <= horizon
+    // of the same entity
+    std::vector<std::byte> candidate;
+    bool has_candidate{false};
+    while (data) {
+        if (result.scanned >= max_scanned || result.erased >= max_erased) {
+            // Resume on the candidate so that it is checked against its successor again
+            result.resume_key = has_candidate ? std::move(candidate) : to_bytes(data.key);
+            return result;
+        }
+        ++result.scanned;
+
+        const ByteView key{from_slice(data.key)};
+        if (key.size() < sizeof(uint64_t) || utils::BlockBE64::decode(key.last<sizeof(uint64_t)>().data()) > horizon) {
+            has_candidate = false;
+        } else {
+            const ByteView entity{key.first(key.size() - sizeof(uint64_t))};
+            if (has_candidate && candidate.size() == key.size() && utils::starts_with(candidate, entity)) {
+                cursor->to_previous(/*throw_notfound=*/false);
+                cursor->erase();
+                data = cursor->to_next(/*throw_notfound=*/false);  // Back on the current record
+                ++result.erased;
+            }
+            // Erasing may have moved the record within its page: copy the key as seen after the erase
+            const ByteView current{from_slice(data.key)};
+            candidate.assign(current.begin(), current.end());
+            has_candidate = true;
+        }
+        data = cursor->to_next(/*throw_notfound=*/false);
+    }
+    return result;
+}
+
+HistoryPruner::HistoryPruner(::mdbx::env env, MapConfig map, const PruneConfig& config)
+    : env_{std::move(env)}, map_{std::move(map)}, config_{config} {}
+
+HistoryPruner::~HistoryPruner() {
+    stop();
+}
+
+void HistoryPruner::start(uint64_t tip_block) {
+    if (thread_.joinable()) {
+        if (phase_ != PrunePhase::kDone) {
+            throw std::logic_error("HistoryPruner: already running");
+        }
+        thread_.join();
+    }
+    const uint64_t horizon{tip_block > config_.retention_blocks ? tip_block - config_.retention_blocks : 0};
+    horizon_ = horizon;
+    scanned_ = 0;
+    erased_ = 0;
+    commits_ = 0;
+    stopped_ = false;
+    failed_ = false;
+    phase_ = PrunePhase::kPruning;
+    thread_ = std::jthread{[this, horizon](std::stop_token stop) { run(stop, horizon); }};
+}
+
+void HistoryPruner::stop() {
+    thread_.request_stop();
+    wait();
+}
+
+void HistoryPruner::wait() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+PruneProgress HistoryPruner::progress() const {
+    return PruneProgress{
+        .phase = phase_.load(std::memory_order_relaxed),
+        .horizon = horizon_.load(std::memory_order_relaxed),
+        .scanned = scanned_.load(std::memory_order_relaxed),
+        .erased = erased_.load(std::memory_order_relaxed),
+        .commits = commits_.load(std::memory_order_relaxed),
+        .stopped = stopped_.load(std::memory_order_relaxed),
+        .failed = failed_.load(std::memory_order_relaxed),
+    };
+}
+
+void HistoryPruner::run(const std::stop_token& stop, uint64_t horizon) {
+    throttle_start_ = std::chrono::steady_clock::now();
+    throttle_erased_ = 0;
+    const Slice checkpoint_key{map_.name};
+    try {
+        std::vector<std::byte> resume_key;
+        {
+            ROTxnManaged txn{env_};
+            if (!has_map(*txn, map_.name)) {
+                phase_ = PrunePhase::kDone;
+                return;
+            }
+            if (has_map(*txn, kPruneCheckpointsMap.name)) {
+                auto checkpoints{txn.ro_cursor(kPruneCheckpointsMap)};
+                if (const auto found{checkpoints->find(checkpoint_key, /*throw_notfound=*/false)}) {
+                    resume_key = to_bytes(found.value);
+                }
+            }
+        }
+
+        while (!stop.stop_requested()) {
+            RWTxnManaged txn{env_};
+            auto step{prune_history_step(txn, map_, horizon, resume_key, config_.max_erased_per_txn,
+                                         config_.max_scanned_per_txn)};
+            {
+                // The checkpoint commits atomically with the erasures it accounts for
+                auto checkpoints{txn.rw_cursor(kPruneCheckpointsMap)};
+                if (step.resume_key) {
+                    checkpoints->upsert(checkpoint_key, to_slice(*step.resume_key));
+                } else {
+                    checkpoints->erase(checkpoint_key);
+                }
+            }
+            txn.commit_and_stop();
+            scanned_ += step.scanned;
+            erased_ += step.erased;
+            ++commits_;
+
+            if (!step.resume_key) break;
+            resume_key = std::move(*step.resume_key);
+            // The write lock is released between transactions, queued writers get in here
+            if (!throttle(stop, step.erased)) break;
+        }
+    } catch (const std::exception&) {
+        // Pruning is best effort: the checkpoint of the last committed transaction stays valid
+        failed_ = true;
+    }
+    stopped_ = stop.stop_requested();
+    phase_ = PrunePhase::kDone;
+}
+
+bool HistoryPruner::throttle(const std::stop_token& stop, size_t erased) {
+    if (!config_.erase_rate) return !stop.stop_requested();
+    throttle_erased_ += erased;
+    const auto due{throttle_start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(static_cast<double>(throttle_erased_) /
+                                                                       static_cast<double>(config_.erase_rate)))};
+    std::unique_lock lock{mutex_};
+    cv_.wait_until(lock, stop, due, [] { return false; });
+    return !stop.stop_requested();
+}
+
+}  // namespace datastore::kvdb
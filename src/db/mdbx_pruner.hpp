@@ -0,0 +1,119 @@
+// Copyright 2025 The Silkworm Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "mdbx.hpp"
+
+namespace datastore::kvdb {
+
+//! \brief Table holding the resume key of interrupted pruning passes, keyed by the name of the pruned map
+inline constexpr MapConfig kPruneCheckpointsMap{"PruneCheckpoints"};
+
+//! \brief Settings of a HistoryPruner
+struct PruneConfig {
+    uint64_t retention_blocks{90'000};     // Versions superseded before tip - retention_blocks are pruned
+    size_t max_erased_per_txn{10_Kibi};    // Max records erased by one write transaction
+    size_t max_scanned_per_txn{256_Kibi};  // Max records visited by one write transaction, bounds its duration
+    size_t erase_rate{100_Kibi};           // Max records erased per second (0 means unlimited)
+};
+
+//! \brief Outcome of one bounded pruning step
+struct PruneStepResult {
+    size_t scanned{0};                                  // Records visited
+    size_t erased{0};                                   // Records erased
+    std::optional<std::vector<std::byte>> resume_key;  // Where the next step starts, nullopt at the end of the map
+};
+
+//! \brief Erases the versions of a history map made useless by a pruning horizon, within a record budget
+//! \param [in] txn : The write transaction to erase in
+//! \param [in] config : The map, whose keys are `entity ‖ big_endian(u64 block)`
+//! \param [in] horizon : Oldest block that must stay queryable
+//! \param [in] start_key : The key where to start (empty for the beginning of the map)
+//! \param [in] max_erased : Stop after erasing this many records
+//! \param [in] max_scanned : Stop after visiting this many records
+//! \details A version is erased when a newer version of the same entity has a block <= horizon: the newest version
+//! <= horizon still answers every "state as of block" query from horizon on, and all the versions above horizon are
+//! kept. Entities are the keys without their last 8 bytes; keys shorter than that are left alone.
+//! \remarks Only erases a version superseded by the record following it, so an entity whose keys interleave with
+//! those of another entity (variable-length names sharing a prefix) may keep a few extra versions, never too few.
+PruneStepResult prune_history_step(RWTxn& txn, const MapConfig& config, uint64_t horizon, ByteView start_key,
+                                   size_t max_erased, size_t max_scanned);
+
+//! \brief Stages a HistoryPruner goes through
+enum class PrunePhase : uint8_t {
+    kIdle,     // Not started yet
+    kPruning,  // Walking the map
+    kDone,     // Finished or stopped
+};
+
+//! \brief Snapshot of the pruning progress
+struct PruneProgress {
+    PrunePhase phase{PrunePhase::kIdle};
+    uint64_t horizon{0};     // Oldest block kept queryable by the current pass
+    uint64_t scanned{0};     // Records visited so far
+    uint64_t erased{0};      // Records erased so far
+    uint64_t commits{0};     // Write transactions committed so far
+    bool stopped{false};     // Whether the pass has been interrupted before completion
+    bool failed{false};      // Whether the pass has been aborted by an error
+};
+
+//! \brief Background job dropping history versions older than a retention window
+//! \details One pass walks the map in key order through short write transactions, each bounded by
+//! PruneConfig::max_erased_per_txn and max_scanned_per_txn so that writers queued on the single MDBX write lock are
+//! not starved, and throttled to PruneConfig::erase_rate. The resume key is committed with each transaction into
+//! kPruneCheckpointsMap, so an interrupted pass (stop, crash) continues where it left off on the next start.
+//! \remarks The pruner does not own the environment, which must outlive it
+class HistoryPruner {
+  public:
+    HistoryPruner(::mdbx::env env, MapConfig map, const PruneConfig& config);
+    ~HistoryPruner();
+
+    HistoryPruner(const HistoryPruner&) = delete;
+    HistoryPruner& operator=(const HistoryPruner&) = delete;
+
+    //! \brief Starts a pass in a background thread, keeping the versions needed from tip_block - retention_blocks on
+    void start(uint64_t tip_block);
+
+    //! \brief Interrupts the pass and waits for the background thread to exit
+    void stop();
+
+    //! \brief Waits for the pass to complete
+    void wait();
+
+    PruneProgress progress() const;
+
+  private:
+    void run(const std::stop_token& stop, uint64_t horizon);
+    bool throttle(const std::stop_token& stop, size_t erased);
+
+    ::mdbx::env env_;
+    MapConfig map_;
+    PruneConfig config_;
+
+    std::atomic<PrunePhase> phase_{PrunePhase::kIdle};
+    std::atomic<uint64_t> horizon_{0};
+    std::atomic<uint64_t> scanned_{0};
+    std::atomic<uint64_t> erased_{0};
+    std::atomic<uint64_t> commits_{0};
+    std::atomic<bool> stopped_{false};
+    std::atomic<bool> failed_{false};
+
+    std::chrono::steady_clock::time_point throttle_start_;
+    uint64_t throttle_erased_{0};
+
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::jthread thread_;
+};
+
+}  // namespace datastore::kvdb
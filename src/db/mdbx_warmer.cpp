@@ -0,0 +1,296 @@
+// Copyright 2025 The Silkworm Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "mdbx_warmer.hpp"
+
+#include "mdbx_heatmap.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <utility>
+
+#ifndef HAVE_LIBURING
+#define HAVE_LIBURING 0
+#endif
+
+#if HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+namespace datastore::kvdb {
+
+namespace {
+
+    //! Largest single read issued while prefaulting hot ranges
+    constexpr uint64_t kPrefetchChunkSize{256_Kibi};
+
+    //! Number of tree descents after which the read transaction is renewed to not hold back page reclaiming
+    constexpr size_t kDescentsPerTxn{4_Kibi};
+
+#if HAVE_LIBURING
+    //! Keeps up to queue depth reads in flight through io_uring, the read data is discarded
+    class RangePrefetcher {
+      public:
+        RangePrefetcher(int fd, uint32_t queue_depth) : fd_{fd} {
+            queue_depth = std::max(queue_depth, 1u);
+            if (const int result{::io_uring_queue_init(queue_depth, &ring_, 0)}; result < 0) {
+                throw std::runtime_error("io_uring_queue_init failed: " + std::to_string(-result));
+            }
+            buffers_.reserve(queue_depth);
+            for (uint32_t slot{0}; slot < queue_depth; ++slot) {
+                buffers_.emplace_back(std::make_unique<std::byte[]>(kPrefetchChunkSize));
+                free_slots_.push_back(slot);
+            }
+        }
+        ~RangePrefetcher() {
+            drain();
+            ::io_uring_queue_exit(&ring_);
+        }
+
+        RangePrefetcher(const RangePrefetcher&) = delete;
+        RangePrefetcher& operator=(const RangePrefetcher&) = delete;
+
+        void prefetch(uint64_t offset, uint64_t length) {
+            if (free_slots_.empty()) {
+                reap(1);
+            }
+            const uint32_t slot{free_slots_.back()};
+            free_slots_.pop_back();
+            io_uring_sqe* sqe{::io_uring_get_sqe(&ring_)};
+            ::io_uring_prep_read(sqe, fd_, buffers_[slot].get(), static_cast<unsigned>(length), offset);
+            ::io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<uintptr_t>(slot)));
+            ::io_uring_submit(&ring_);
+        }
+
+        void drain() { reap(buffers_.size() - free_slots_.size()); }
+
+      private:
+        void reap(size_t count) {
+            for (size_t i{0}; i < count; ++i) {
+                io_uring_cqe* cqe{nullptr};
+                if (::io_uring_wait_cqe(&ring_, &cqe) < 0) {
+                    return;
+                }
+                // Short or failed reads are fine here: the goal is only to fault pages in
+                free_slots_.push_back(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(::io_uring_cqe_get_data(cqe))));
+                ::io_uring_cqe_seen(&ring_, cqe);
+            }
+        }
+
+        int fd_;
+        io_uring ring_{};
+        std::vector<std::unique_ptr<std::byte[]>> buffers_;
+        std::vector<uint32_t> free_slots_;
+    };
+#else
+    //! Asks the kernel to read ahead the ranges asynchronously
+    class RangePrefetcher {
+      public:
+        RangePrefetcher(int fd, uint32_t /*queue_depth*/) : fd_{fd} {}
+
+        void prefetch(uint64_t offset, uint64_t length) {
+            ::posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+        }
+
+        void drain() {}
+
+      private:
+        int fd_;
+    };
+#endif
+
+    //! Closes the file descriptor on scope exit
+    struct FileDescriptor {
+        explicit FileDescriptor(int fd) : fd{fd} {}
+        ~FileDescriptor() {
+            if (fd >= 0) ::close(fd);
+        }
+        FileDescriptor(const FileDescriptor&) = delete;
+        FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+        int fd;
+    };
+
+    std::vector<std::byte> to_bytes(const Slice& slice) {
+        const auto* data{static_cast<const std::byte*>(slice.data())};
+        return {data, data + slice.size()};
+    }
+
+}  // namespace
+
+PageWarmer::PageWarmer(::mdbx::env env, const EnvConfig& config, std::vector<MapConfig> maps)
+    : env_{std::move(env)},
+      data_file_{get_datafile_path(config.path)},
+      bandwidth_{config.warmup_bandwidth},
+      tree_samples_{config.warmup_tree_samples},
+      queue_depth_{config.warmup_queue_depth},
+      maps_{std::move(maps)} {}
+
+PageWarmer::~PageWarmer() {
+    stop();
+}
+
+void PageWarmer::add_hot_ranges(const std::vector<WarmupRange>& ranges) {
+    if (thread_.joinable()) {
+        throw std::logic_error("PageWarmer: hot ranges must be added before start");
+    }
+    hot_ranges_.insert(hot_ranges_.end(), ranges.begin(), ranges.end());
+}
+
+void PageWarmer::start() {
+    if (thread_.joinable()) {
+        throw std::logic_error("PageWarmer: already started");
+    }
+    thread_ = std::jthread{[this](std::stop_token stop) { run(stop); }};
+}
+
+void PageWarmer::stop() {
+    thread_.request_stop();
+    wait();
+}
+
+void PageWarmer::wait() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+WarmupProgress PageWarmer::progress() const {
+    return WarmupProgress{
+        .phase = phase_.load(std::memory_order_relaxed),
+        .tree_descents = tree_descents_.load(std::memory_order_relaxed),
+        .hot_bytes_total = hot_bytes_total_.load(std::memory_order_relaxed),
+        .hot_bytes_done = hot_bytes_done_.load(std::memory_order_relaxed),
+        .stopped = stopped_.load(std::memory_order_relaxed),
+        .failed = failed_.load(std::memory_order_relaxed),
+    };
+}
+
+void PageWarmer::run(const std::stop_token& stop) {
+    throttle_start_ = std::chrono::steady_clock::now();
+    throttle_bytes_ = 0;
+    try {
+        phase_ = WarmupPhase::kTree;
+        for (const auto& map : maps_) {
+            if (stop.stop_requested()) break;
+            warm_tree(stop, map);
+        }
+        phase_ = WarmupPhase::kHotRanges;
+        if (!stop.stop_requested()) {
+            warm_hot_ranges(stop);
+        }
+    } catch (const std::exception&) {
+        // Warm-up is best effort: a failure only leaves the page cache colder
+        failed_ = true;
+    }
+    stopped_ = stop.stop_requested();
+    phase_ = WarmupPhase::kDone;
+}
+
+void PageWarmer::warm_tree(const std::stop_token& stop, const MapConfig& map) {
+    // Each descent touches one page per tree level
+    uint64_t bytes_per_descent{0};
+    std::deque<std::pair<std::vector<std::byte>, std::vector<std::byte>>> ranges;
+    {
+        ROTxnManaged txn{env_};
+        if (!has_map(*txn, map.name)) return;
+        PooledCursor cursor{txn, map};
+        const auto stat{cursor.get_map_stat()};
+        bytes_per_descent = static_cast<uint64_t>(stat.ms_psize) * std::max(stat.ms_depth, 1u);
+        const auto first{cursor.to_first(/*throw_notfound=*/false)};
+        if (!first) return;
+        auto lo{to_bytes(first.key)};
+        const auto last{cursor.to_last(/*throw_notfound=*/false)};
+        auto hi{to_bytes(last.key)};
+        ranges.emplace_back(std::move(lo), std::move(hi));
+        tree_descents_ += 2;
+    }
+
+    // Breadth-first bisection of the key space: each round halves the gaps between already visited keys, so the
+    // descents spread evenly over the leaves whatever the key distribution
+    size_t descents{0};
+    while (!ranges.empty() && descents < tree_samples_) {
+        ROTxnManaged txn{env_};
+        PooledCursor cursor{txn, map};
+        for (size_t i{0}; i < kDescentsPerTxn && !ranges.empty() && descents < tree_samples_; ++i) {
+            auto [lo, hi] = std::move(ranges.front());
+            ranges.pop_front();
+
+            const auto mid{detail::key_midpoint(lo, hi)};
+            const auto data{cursor.lower_bound(Slice{mid.data(), mid.size()}, /*throw_notfound=*/false)};
+            ++descents;
+            ++tree_descents_;
+            if (!throttle(stop, bytes_per_descent)) return;
+            if (!data) continue;
+
+            auto key{to_bytes(data.key)};
+            if (!std::ranges::lexicographical_compare(lo, key) || !std::ranges::lexicographical_compare(key, hi)) {
+                continue;  // No key strictly inside this range
+            }
+            ranges.emplace_back(std::move(lo), key);
+            ranges.emplace_back(std::move(key), std::move(hi));
+        }
+    }
+}
+
+void PageWarmer::warm_hot_ranges(const std::stop_token& stop) {
+    if (hot_ranges_.empty()) return;
+
+    FileDescriptor file{::open(data_file_.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (file.fd < 0) {
+        throw std::runtime_error("Unable to open " + data_file_.string());
+    }
+    const auto file_size{static_cast<uint64_t>(std::filesystem::file_size(data_file_))};
+
+    uint64_t total{0};
+    for (auto& range : hot_ranges_) {
+        range.offset = std::min(range.offset, file_size);
+        range.length = std::min(range.length, file_size - range.offset);
+        total += range.length;
+    }
+    hot_bytes_total_ = total;
+
+    RangePrefetcher prefetcher{file.fd, queue_depth_};
+    for (const auto& range : hot_ranges_) {
+        for (uint64_t done{0}; done < range.length;) {
+            const uint64_t length{std::min(kPrefetchChunkSize, range.length - done)};
+            prefetcher.prefetch(range.offset + done, length);
+            done += length;
+            hot_bytes_done_ += length;
+            if (!throttle(stop, length)) return;
+        }
+    }
+    prefetcher.drain();
+}
+
+bool PageWarmer::throttle(const std::stop_token& stop, uint64_t bytes) {
+    if (!bandwidth_) return !stop.stop_requested();
+    throttle_bytes_ += bytes;
+    const auto due{throttle_start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(static_cast<double>(throttle_bytes_) /
+                                                                       static_cast<double>(bandwidth_)))};
+    std::unique_lock lock{mutex_};
+    cv_.wait_until(lock, stop, due, [] { return false; });
+    return !stop.stop_requested();
+}
+
+std::unique_ptr<PageWarmer> start_page_warmer(::mdbx::env env, const EnvConfig& config, std::vector<MapConfig> maps) {
+    if (!config.warmup) return nullptr;
+    auto warmer{std::make_unique<PageWarmer>(std::move(env), config, std::move(maps))};
+    // The heatmap of previous sessions restricts prefaulting to the actual working set
+    try {
+        if (const auto heatmap{AccessHeatmap::load(get_heatmap_path(config.path))}) {
+            warmer->add_hot_ranges(heatmap->hot_ranges());
+        }
+    } catch (const std::runtime_error&) {
+        // Without a usable heatmap only the tree walk is done
+    }
+    warmer->start();
+    return warmer;
+}
+
+}  // namespace datastore::kvdb
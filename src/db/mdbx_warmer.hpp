@@ -0,0 +1,107 @@
+// Copyright 2025 The Silkworm Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mdbx.hpp"
+
+namespace datastore::kvdb {
+
+//! \brief A byte range of the data file to be brought into the page cache
+struct WarmupRange {
+    uint64_t offset{0};
+    uint64_t length{0};
+};
+
+//! \brief Stages a PageWarmer goes through
+enum class WarmupPhase : uint8_t {
+    kIdle,       // Not started yet
+    kTree,       // Descending sampled keys to fault in branch pages
+    kHotRanges,  // Prefaulting hot ranges of the data file
+    kDone,       // Finished or stopped
+};
+
+//! \brief Snapshot of the warm-up progress
+struct WarmupProgress {
+    WarmupPhase phase{WarmupPhase::kIdle};
+    size_t tree_descents{0};        // Number of sampled descents done so far
+    uint64_t hot_bytes_total{0};    // Overall size of the hot ranges to prefault
+    uint64_t hot_bytes_done{0};     // Size of the hot ranges prefaulted so far
+    bool stopped{false};            // Whether the warm-up has been interrupted before completion
+    bool failed{false};             // Whether the warm-up has been aborted by an error
+};
+
+//! \brief Background page warmer for cold-started environments
+//! \details The warmer first walks the B-tree of each provided map through evenly spread key descents, which brings
+//! all the upper branch levels into the page cache, then prefaults the provided hot ranges of the data file. Reads use
+//! io_uring when built with HAVE_LIBURING, otherwise POSIX_FADV_WILLNEED hints. The overall read rate is capped by
+//! EnvConfig::warmup_bandwidth.
+//! \remarks The warmer does not own the environment, which must outlive it
+class PageWarmer {
+  public:
+    PageWarmer(::mdbx::env env, const EnvConfig& config, std::vector<MapConfig> maps);
+    ~PageWarmer();
+
+    PageWarmer(const PageWarmer&) = delete;
+    PageWarmer& operator=(const PageWarmer&) = delete;
+
+    //! \brief Adds ranges of the data file to prefault after the tree walk
+    //! \remarks Must be called before start()
+    void add_hot_ranges(const std::vector<WarmupRange>& ranges);
+
+    //! \brief Starts warming up in a background thread
+    void start();
+
+    //! \brief Interrupts the warm-up and waits for the background thread to exit
+    void stop();
+
+    //! \brief Waits for the warm-up to complete
+    void wait();
+
+    WarmupProgress progress() const;
+
+  private:
+    void run(const std::stop_token& stop);
+    void warm_tree(const std::stop_token& stop, const MapConfig& map);
+    void warm_hot_ranges(const std::stop_token& stop);
+    bool throttle(const std::stop_token& stop, uint64_t bytes);
+
+    ::mdbx::env env_;
+    std::filesystem::path data_file_;
+    size_t bandwidth_;
+    size_t tree_samples_;
+    uint32_t queue_depth_;
+    std::vector<MapConfig> maps_;
+    std::vector<WarmupRange> hot_ranges_;
+
+    std::atomic<WarmupPhase> phase_{WarmupPhase::kIdle};
+    std::atomic<size_t> tree_descents_{0};
+    std::atomic<uint64_t> hot_bytes_total_{0};
+    std::atomic<uint64_t> hot_bytes_done_{0};
+    std::atomic<bool> stopped_{false};
+    std::atomic<bool> failed_{false};
+
+    std::chrono::steady_clock::time_point throttle_start_;
+    uint64_t throttle_bytes_{0};
+
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::jthread thread_;
+};
+
+//! \brief Starts a PageWarmer on the provided maps if warm-up is enabled in the environment config
+//! \details The hot ranges are taken from the access heatmap saved next to the data file, if any
+//! \return The running warmer or nullptr when EnvConfig::warmup is not set
+std::unique_ptr<PageWarmer> start_page_warmer(::mdbx::env env, const EnvConfig& config, std::vector<MapConfig> maps);
+
+}  // namespace datastore::kvdb
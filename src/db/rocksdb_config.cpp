@@ -0,0 +1,154 @@
+#include "db/rocksdb_config.hpp"
+
+#include <fmt/format.h>
+#include <json/json.h>
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef HAVE_ROCKSDB
+#define HAVE_ROCKSDB 0
+#endif
+
+#if HAVE_ROCKSDB
+#include <rocksdb/cache.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/options.h>
+#include <rocksdb/table.h>
+#endif
+
+RocksDBConfig load_rocksdb_config(const std::string& config_file) {
+    RocksDBConfig config;
+
+    // Try to load from file if it exists
+    if (!config_file.empty() && std::filesystem::exists(config_file)) {
+        try {
+            std::ifstream file(config_file);
+            Json::Value root;
+            file >> root;
+
+            if (root.isMember("path")) config.path = root["path"].asString();
+            if (root.isMember("create_if_missing")) config.create_if_missing = root["create_if_missing"].asBool();
+            if (root.isMember("max_open_files")) config.max_open_files = root["max_open_files"].asInt();
+            if (root.isMember("write_buffer_size")) config.write_buffer_size = root["write_buffer_size"].asUInt64();
+            if (root.isMember("max_write_buffer_number")) config.max_write_buffer_number = root["max_write_buffer_number"].asInt();
+            if (root.isMember("target_file_size_base")) config.target_file_size_base = root["target_file_size_base"].asUInt64();
+            if (root.isMember("max_bytes_for_level_base")) config.max_bytes_for_level_base = root["max_bytes_for_level_base"].asUInt64();
+            if (root.isMember("level0_file_num_compaction_trigger")) config.level0_file_num_compaction_trigger = root["level0_file_num_compaction_trigger"].asInt();
+            if (root.isMember("level0_slowdown_writes_trigger")) config.level0_slowdown_writes_trigger = root["level0_slowdown_writes_trigger"].asInt();
+            if (root.isMember("level0_stop_writes_trigger")) config.level0_stop_writes_trigger = root["level0_stop_writes_trigger"].asInt();
+            if (root.isMember("max_background_jobs")) config.max_background_jobs = root["max_background_jobs"].asInt();
+            if (root.isMember("use_direct_reads")) config.use_direct_reads = root["use_direct_reads"].asBool();
+            if (root.isMember("use_direct_io_for_flush_and_compaction")) config.use_direct_io_for_flush_and_compaction = root["use_direct_io_for_flush_and_compaction"].asBool();
+            if (root.isMember("compression_per_level")) {
+                config.compression_per_level.clear();
+                for (const auto& level : root["compression_per_level"]) {
+                    config.compression_per_level.push_back(level.asString());
+                }
+            }
+            if (root.isMember("block_cache_size")) config.block_cache_size = root["block_cache_size"].asUInt64();
+            if (root.isMember("block_cache_type")) config.block_cache_type = root["block_cache_type"].asString();
+            if (root.isMember("block_size")) config.block_size = root["block_size"].asUInt64();
+            if (root.isMember("cache_index_and_filter_blocks")) config.cache_index_and_filter_blocks = root["cache_index_and_filter_blocks"].asBool();
+            if (root.isMember("partitioned_index_filters")) config.partitioned_index_filters = root["partitioned_index_filters"].asBool();
+            if (root.isMember("whole_key_filtering")) config.whole_key_filtering = root["whole_key_filtering"].asBool();
+            if (root.isMember("prefix_bloom")) config.prefix_bloom = root["prefix_bloom"].asBool();
+            if (root.isMember("prefix_length")) config.prefix_length = root["prefix_length"].asUInt64();
+            if (root.isMember("bloom_bits_per_key")) config.bloom_bits_per_key = root["bloom_bits_per_key"].asDouble();
+            if (root.isMember("memtable_prefix_bloom_size_ratio")) config.memtable_prefix_bloom_size_ratio = root["memtable_prefix_bloom_size_ratio"].asDouble();
+            if (root.isMember("latest_state_cf")) config.latest_state_cf = root["latest_state_cf"].asBool();
+            if (root.isMember("history_compaction")) config.history_compaction = root["history_compaction"].asString();
+            if (root.isMember("history_fifo_max_size")) config.history_fifo_max_size = root["history_fifo_max_size"].asUInt64();
+            if (root.isMember("history_blob_files")) config.history_blob_files = root["history_blob_files"].asBool();
+            if (root.isMember("history_min_blob_size")) config.history_min_blob_size = root["history_min_blob_size"].asUInt64();
+            if (root.isMember("iterator_staleness_ms")) config.iterator_staleness_ms = root["iterator_staleness_ms"].asUInt();
+            if (root.isMember("iterator_max_age_ms")) config.iterator_max_age_ms = root["iterator_max_age_ms"].asUInt();
+            if (root.isMember("iterator_pool_size")) config.iterator_pool_size = root["iterator_pool_size"].asUInt64();
+
+            fmt::println("✓ Loaded RocksDBConfig from: {}", config_file);
+        } catch (const std::exception& e) {
+            fmt::println("⚠ Failed to load config file {}, using defaults: {}", config_file, e.what());
+        }
+    } else {
+        fmt::println("✓ Using default RocksDBConfig (file not found: {})", config_file);
+    }
+
+    return config;
+}
+
+#if HAVE_ROCKSDB
+
+namespace {
+
+rocksdb::CompressionType parse_compression(const std::string& name) {
+    if (name == "none") return rocksdb::kNoCompression;
+    if (name == "snappy") return rocksdb::kSnappyCompression;
+    if (name == "lz4") return rocksdb::kLZ4Compression;
+    if (name == "lz4hc") return rocksdb::kLZ4HCCompression;
+    if (name == "zstd") return rocksdb::kZSTD;
+    throw std::invalid_argument(fmt::format("Unknown RocksDB compression: {}", name));
+}
+
+std::shared_ptr<rocksdb::Cache> make_block_cache(const RocksDBConfig& config) {
+    if (config.block_cache_type == "hyper_clock") {
+        // An estimated entry charge of 0 lets the cache size its table automatically
+        return rocksdb::HyperClockCacheOptions(config.block_cache_size, 0).MakeSharedCache();
+    }
+    if (config.block_cache_type == "lru") {
+        return rocksdb::NewLRUCache(config.block_cache_size);
+    }
+    throw std::invalid_argument(fmt::format("Unknown RocksDB block cache type: {}", config.block_cache_type));
+}
+
+} // namespace
+
+void apply_rocksdb_config(const RocksDBConfig& config, rocksdb::Options& options) {
+    options.create_if_missing = config.create_if_missing;
+    options.max_open_files = config.max_open_files;
+    options.write_buffer_size = config.write_buffer_size;
+    options.max_write_buffer_number = config.max_write_buffer_number;
+    options.target_file_size_base = config.target_file_size_base;
+    options.max_bytes_for_level_base = config.max_bytes_for_level_base;
+    options.level0_file_num_compaction_trigger = config.level0_file_num_compaction_trigger;
+    options.level0_slowdown_writes_trigger = config.level0_slowdown_writes_trigger;
+    options.level0_stop_writes_trigger = config.level0_stop_writes_trigger;
+    options.max_background_jobs = config.max_background_jobs;
+    options.use_direct_reads = config.use_direct_reads;
+    options.use_direct_io_for_flush_and_compaction = config.use_direct_io_for_flush_and_compaction;
+
+    if (!config.compression_per_level.empty()) {
+        options.compression_per_level.clear();
+        for (const auto& name : config.compression_per_level) {
+            options.compression_per_level.push_back(parse_compression(name));
+        }
+        // Deeper levels than listed use the last entry
+        while (options.compression_per_level.size() < static_cast<size_t>(options.num_levels)) {
+            options.compression_per_level.push_back(options.compression_per_level.back());
+        }
+    }
+
+    rocksdb::BlockBasedTableOptions table_options;
+    if (config.block_cache_size > 0) {
+        table_options.block_cache = make_block_cache(config);
+    } else {
+        table_options.no_block_cache = true;
+    }
+    table_options.block_size = config.block_size;
+    table_options.cache_index_and_filter_blocks = config.cache_index_and_filter_blocks;
+    // L0 files are read by every lookup, keep their index and filter resident
+    table_options.pin_l0_filter_and_index_blocks_in_cache = config.cache_index_and_filter_blocks;
+    if (config.bloom_bits_per_key > 0) {
+        table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(config.bloom_bits_per_key));
+    }
+    table_options.whole_key_filtering = config.whole_key_filtering;
+    if (config.partitioned_index_filters) {
+        // Only the top-level index stays in memory, partitions are loaded through the block cache on demand
+        table_options.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+        table_options.partition_filters = config.bloom_bits_per_key > 0;
+        table_options.metadata_block_size = 4096;
+    }
+    options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+}
+
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rocksdb {
+struct Options;
+} // namespace rocksdb
+
+/**
+ * @brief RocksDB settings shared by RocksDbImpl and the rocksdb_bench tool.
+ */
+struct RocksDBConfig {
+    std::string path = "/data/rocksdb_bench";
+    bool create_if_missing = true;
+    int max_open_files = 300;
+    size_t write_buffer_size = 64 << 20;    // 64MB
+    int max_write_buffer_number = 3;
+    size_t target_file_size_base = 64 << 20;  // 64MB
+    size_t max_bytes_for_level_base = 256 << 20;  // 256MB
+    int level0_file_num_compaction_trigger = 4;
+    int level0_slowdown_writes_trigger = 20;
+    int level0_stop_writes_trigger = 36;
+    int max_background_jobs = 4;                   // Flush + compaction threads
+    bool use_direct_reads = false;                 // O_DIRECT user reads, the block cache replaces the page cache
+    bool use_direct_io_for_flush_and_compaction = false;
+
+    // Compression of each level, from L0 down: "none", "snappy", "lz4", "lz4hc", "zstd". Empty keeps the RocksDB
+    // default (snappy everywhere); levels past the end of the list use its last entry. Every listed algorithm must be
+    // compiled into RocksDB or DB::Open fails, see configs/rocksdb_performance.json for a tuned list.
+    std::vector<std::string> compression_per_level;
+
+    // BlockBasedTableOptions
+    size_t block_cache_size = 512 << 20;           // 512MB, 0 disables the block cache
+    std::string block_cache_type = "hyper_clock";  // "hyper_clock" (lock-free, scales with readers) or "lru"
+    size_t block_size = 4 << 10;                   // 4KB data blocks
+    bool cache_index_and_filter_blocks = true;     // Charge index and filter blocks to the block cache
+    bool partitioned_index_filters = false;        // Two-level index and partitioned filters, for very large DBs
+    bool whole_key_filtering = true;               // Bloom filter on whole keys, for point lookups
+
+    // Prefix seek for the `account + big_endian(block)` keys of RocksDbImpl. With a prefix extractor on the account
+    // part, lookbacks only consult the SST files whose prefix bloom filter may contain the account.
+    bool prefix_bloom = true;                      // Prefix extractor + prefix bloom filter, false for total order
+    size_t prefix_length = 0;                      // Fixed prefix length (e.g. 20 for addresses), 0 = key minus its block suffix
+    double bloom_bits_per_key = 10.0;              // ~1% false positives, 0 disables bloom filters
+    double memtable_prefix_bloom_size_ratio = 0.1; // Share of the write buffer used by the memtable prefix bloom
+
+    // Column families of RocksDbImpl. The default column family holds the history, one `account + big_endian(block)` key
+    // per version. With latest_state_cf, a "latest_state" column family also keeps the newest version of each account
+    // under the bare account key, so queries at or after that version are one point lookup in a small, hot CF.
+    bool latest_state_cf = false;
+    std::string history_compaction = "level";      // "level", "universal" (less write amplification) or "fifo"
+    size_t history_fifo_max_size = 0;              // "fifo": oldest history files are dropped past that size, 0 = 1GB
+    bool history_blob_files = false;               // BlobDB: history values go to blob files, SSTs keep the keys
+    size_t history_min_blob_size = 64;             // Smaller values stay inline in the SSTs
+
+    // Iterator reuse for the lookbacks of RocksDbImpl: pooled iterators skip the allocation and index reads of a new
+    // iterator, and are brought up to date with Iterator::Refresh().
+    // Consistency knob: a lookback may miss the writes of the last iterator_staleness_ms, including those made through
+    // the same RocksDbImpl. 0 refreshes on every lookback, so that every write is seen by the next lookback.
+    uint32_t iterator_staleness_ms = 0;
+    uint32_t iterator_max_age_ms = 10'000;  // Iterators are recreated after that, releasing the data they pin
+    size_t iterator_pool_size = 64;         // Max idle iterators kept, 0 disables the pool
+};
+
+/**
+ * @brief Loads a RocksDBConfig from a JSON file, whose missing fields keep their defaults.
+ * @param config_file Path of the JSON file, defaults are used when it is empty or does not exist.
+ */
+RocksDBConfig load_rocksdb_config(const std::string& config_file);
+
+/**
+ * @brief Sets the DB, column family and block-based table options described by config.
+ *
+ * The prefix extractor is left to the caller, which knows its key layout; whole_key_filtering then usually goes off.
+ * @throws std::invalid_argument on an unknown compression or block cache type.
+ */
+void apply_rocksdb_config(const RocksDBConfig& config, rocksdb::Options& options);
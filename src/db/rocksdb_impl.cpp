@@ -1,43 +1,324 @@
 #include "db/rocksdb_impl.hpp"
-#include "utils/endian.hpp"
+#include "db/db_metrics.hpp"
+#include "db/rocksdb_iterator_pool.hpp"
+#include "utils/composite_key.hpp"
+#include "utils/simd_compare.hpp"
 
 #include <fmt/core.h>
 #include <rocksdb/db.h>
 #include <rocksdb/iterator.h>
+#include <rocksdb/merge_operator.h>
 #include <rocksdb/options.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/table.h>
+#include <rocksdb/write_batch.h>
 
-#include <stdexcept>
+#include <algorithm>
 #include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+constexpr auto kLatestStateCf = "latest_state";
+
+// Merges versions of the latest_state column family, whose values are `big_endian(block) + state`, into the one with
+// the highest block: writes never read the current latest version, and blocks may be imported out of order.
+class LatestVersionMerge final : public rocksdb::AssociativeMergeOperator {
+public:
+    const char* Name() const override { return "LatestVersionMerge"; }
+
+    bool Merge(const rocksdb::Slice& /*key*/, const rocksdb::Slice* existing_value, const rocksdb::Slice& value,
+               std::string* new_value, rocksdb::Logger* /*logger*/) const override {
+        if (value.size() < sizeof(uint64_t)) {
+            return false;  // Corrupt operand, fails the read or compaction
+        }
+        const auto* kept = &value;
+        if (existing_value != nullptr && existing_value->size() >= sizeof(uint64_t) &&
+            block_of(*existing_value) > block_of(value)) {
+            kept = existing_value;
+        }
+        new_value->assign(kept->data(), kept->size());
+        return true;
+    }
+
+    static uint64_t block_of(const rocksdb::Slice& latest_value) {
+        return utils::BlockBE64::decode(reinterpret_cast<const std::byte*>(latest_value.data()));
+    }
+};
+
+// Adds one version to a batch: into the history, and into the latest_state column family when there is one
+void add_version(rocksdb::WriteBatch& batch, rocksdb::ColumnFamilyHandle* history_cf, rocksdb::ColumnFamilyHandle* latest_cf,
+                 std::span<const std::byte> key, std::span<const std::byte> value) {
+    const rocksdb::Slice key_slice(reinterpret_cast<const char*>(key.data()), key.size());
+    const rocksdb::Slice value_slice(reinterpret_cast<const char*>(value.data()), value.size());
+    batch.Put(history_cf, key_slice, value_slice);
+    if (latest_cf == nullptr || key.size() < sizeof(uint64_t)) {
+        return;
+    }
+    const size_t account_size = key.size() - sizeof(uint64_t);
+    std::string latest_value;
+    latest_value.reserve(sizeof(uint64_t) + value.size());
+    latest_value.append(key_slice.data() + account_size, sizeof(uint64_t));
+    latest_value.append(value_slice.data(), value_slice.size());
+    batch.Merge(latest_cf, rocksdb::Slice(key_slice.data(), account_size), latest_value);
+}
+
+// The history gets most of the writes and is rarely read far back: universal compaction rewrites it less often than
+// level compaction, FIFO bounds it like a retention window, and blob files keep values out of the compactions.
+void configure_history(rocksdb::Options& options, const RocksDBConfig& config) {
+    if (config.history_compaction == "universal") {
+        options.compaction_style = rocksdb::kCompactionStyleUniversal;
+    } else if (config.history_compaction == "fifo") {
+        options.compaction_style = rocksdb::kCompactionStyleFIFO;
+        if (config.history_fifo_max_size > 0) {
+            options.compaction_options_fifo.max_table_files_size = config.history_fifo_max_size;
+        }
+    } else if (config.history_compaction != "level") {
+        throw std::invalid_argument(fmt::format("Unknown history compaction style: {}", config.history_compaction));
+    }
+    if (config.history_blob_files) {
+        options.enable_blob_files = true;
+        options.min_blob_size = config.history_min_blob_size;
+        options.enable_blob_garbage_collection = true;
+    }
+}
+
+// Point lookups by account only, level compaction keeps them to a few SST reads.
+// The table options are those of the history, whose block cache is shared: both column families draw on one
+// block_cache_size budget. Only whole key filtering differs, turned off on the history by prefix seeks.
+auto latest_state_options(const RocksDBConfig& config, const rocksdb::Options& history_options)
+    -> rocksdb::ColumnFamilyOptions {
+    RocksDBConfig latest_config = config;
+    latest_config.block_cache_size = 0;  // The table factory is replaced below, do not build a cache for it
+    rocksdb::Options options;
+    apply_rocksdb_config(latest_config, options);
+    options.compaction_style = rocksdb::kCompactionStyleLevel;
+    options.merge_operator = std::make_shared<LatestVersionMerge>();
+
+    const auto* history_table = history_options.table_factory->GetOptions<rocksdb::BlockBasedTableOptions>();
+    if (history_table->whole_key_filtering) {
+        options.table_factory = history_options.table_factory;
+    } else {
+        rocksdb::BlockBasedTableOptions table_options = *history_table;
+        table_options.whole_key_filtering = true;
+        options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+    }
+    return rocksdb::ColumnFamilyOptions(options);
+}
+
+// Prefix of `account + big_endian(block)` keys made of the account part, whatever its length.
+// Valid as long as account names do not continue with bytes lower than the high byte of block numbers, which holds
+// for printable names and blocks below 2^56: the keys of an account then stay contiguous.
+class AccountPrefixTransform final : public rocksdb::SliceTransform {
+public:
+    const char* Name() const override { return "AccountPrefixTransform"; }
+
+    rocksdb::Slice Transform(const rocksdb::Slice& key) const override {
+        return {key.data(), key.size() - sizeof(uint64_t)};
+    }
+
+    bool InDomain(const rocksdb::Slice& key) const override { return key.size() >= sizeof(uint64_t); }
+};
+
+// Lookbacks are SeekForPrev calls within one account: a prefix bloom filter on the account part lets them skip the
+// SST files not holding the account, which whole-key filters cannot do for a seek.
+void configure_prefix_seek(rocksdb::Options& options, rocksdb::ReadOptions& seek_options, const RocksDBConfig& config) {
+    RocksDBConfig table_config = config;
+    if (config.prefix_bloom) {
+        table_config.whole_key_filtering = false;  // Never queried by whole key, only by account prefix
+    }
+    apply_rocksdb_config(table_config, options);
+    if (!config.prefix_bloom) {
+        return;
+    }
+    if (config.prefix_length > 0) {
+        options.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(config.prefix_length));
+    } else {
+        options.prefix_extractor = std::make_shared<AccountPrefixTransform>();
+    }
+    options.memtable_prefix_bloom_size_ratio = config.memtable_prefix_bloom_size_ratio;
+    seek_options.prefix_same_as_start = true;
+}
+
+auto db_metrics() -> const DbMetrics& {
+    static const DbMetrics metrics{"rocksdb"};
+    return metrics;
+}
+
+// Queries answered by the latest_state column family, the others need a lookback
+void count_latest_state_lookup(bool hit) {
+    if (!utils::metrics_enabled()) {
+        return;
+    }
+    static utils::Counter& hits = DbMetrics::cache("rocksdb", "latest_state", /*hit=*/true);
+    static utils::Counter& misses = DbMetrics::cache("rocksdb", "latest_state", /*hit=*/false);
+    (hit ? hits : misses).add();
+}
+
+// State of an account as of a block: the value of the largest `account + big_endian(block)` key <= the target
+auto lookback(rocksdb::Iterator& iter, std::string_view account_name, uint64_t block_number)
+    -> std::optional<std::vector<std::byte>> {
+    if (!utils::CompositeKey::fits(account_name)) {
+        return std::nullopt;  // Never stored, writes reject such names
+    }
+
+    // 1. Construct the target key on the stack: account_name + big_endian(block_number)
+    const utils::CompositeKey target_key{account_name, block_number};
+
+    rocksdb::Slice target_slice(reinterpret_cast<const char*>(target_key.data()), target_key.size());
+
+    // 2. Use SeekForPrev to find the largest key <= our target key
+    iter.SeekForPrev(target_slice);
+
+    if (!iter.Valid()) {
+        // No key found that is <= target_key, return nullopt
+        return std::nullopt;
+    }
+
+    // 3. Validate that the found key belongs to the correct account
+    rocksdb::Slice found_key = iter.key();
+    const std::span<const std::byte> found_key_bytes{reinterpret_cast<const std::byte*>(found_key.data()),
+                                                     found_key.size()};
+
+    // Check if the key starts with our account name and has enough bytes for the block number
+    if (found_key_bytes.size() == account_name.length() + sizeof(uint64_t) &&
+        utils::starts_with(found_key_bytes, account_name)) {
+
+        // Extract the block number from the found key
+        uint64_t found_block = utils::BlockBE64::decode(found_key_bytes.data() + account_name.length());
+
+        // Verify that the found block is <= requested block
+        if (found_block <= block_number) {
+            // 4. Return the value
+            rocksdb::Slice found_value = iter.value();
+            const auto* value_ptr = reinterpret_cast<const std::byte*>(found_value.data());
+            return std::vector<std::byte>{value_ptr, value_ptr + found_value.size()};
+        }
+    }
+
+    // 5. If no suitable key was found, return nullopt
+    return std::nullopt;
+}
+
+} // namespace
 
 // --- PImpl Definition ---
 struct RocksDbImpl::RocksDbPimpl {
+    explicit RocksDbPimpl(const RocksDBConfig& config) : iterators{config} {}
+
     std::unique_ptr<rocksdb::DB> db;
+    std::unique_ptr<rocksdb::ColumnFamilyHandle> history_cf;  // The default column family
+    std::unique_ptr<rocksdb::ColumnFamilyHandle> latest_cf;   // Null unless RocksDBConfig::latest_state_cf
     rocksdb::Options options;
+    rocksdb::ReadOptions seek_options;  // Read options of the get_state lookbacks
+    IteratorPool iterators;             // Declared after db, destroyed before it
+
+    // State at block_number from the latest_state column family, nullopt when not there or newer than block_number
+    auto find_latest(std::string_view account_name, uint64_t block_number) -> std::optional<std::vector<std::byte>> {
+        rocksdb::PinnableSlice latest;
+        const rocksdb::Status status = db->Get(rocksdb::ReadOptions(), latest_cf.get(),
+                                               rocksdb::Slice(account_name.data(), account_name.size()), &latest);
+        if (status.IsNotFound()) {
+            return std::nullopt;
+        }
+        if (!status.ok()) {
+            throw std::runtime_error(fmt::format("RocksDB latest state lookup failed: {}", status.ToString()));
+        }
+        return latest_if_visible(latest, block_number);
+    }
+
+    static auto latest_if_visible(const rocksdb::Slice& latest, uint64_t block_number)
+        -> std::optional<std::vector<std::byte>> {
+        if (latest.size() < sizeof(uint64_t) || LatestVersionMerge::block_of(latest) > block_number) {
+            return std::nullopt;
+        }
+        const auto* state = reinterpret_cast<const std::byte*>(latest.data()) + sizeof(uint64_t);
+        return std::vector<std::byte>{state, state + latest.size() - sizeof(uint64_t)};
+    }
+
+    // Fills the latest_state column family from the history of a database created without it
+    void backfill_latest() {
+        const std::unique_ptr<rocksdb::Iterator> iter{db->NewIterator(rocksdb::ReadOptions(), history_cf.get())};
+        rocksdb::WriteBatch batch;
+        auto flush = [&] {
+            const rocksdb::Status status = db->Write(rocksdb::WriteOptions(), &batch);
+            if (!status.ok()) {
+                throw std::runtime_error(fmt::format("RocksDB latest state backfill failed: {}", status.ToString()));
+            }
+            batch.Clear();
+        };
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            const rocksdb::Slice key = iter->key();
+            const rocksdb::Slice value = iter->value();
+            if (key.size() < sizeof(uint64_t)) {
+                continue;
+            }
+            const size_t account_size = key.size() - sizeof(uint64_t);
+            std::string latest_value{key.data() + account_size, sizeof(uint64_t)};
+            latest_value.append(value.data(), value.size());
+            batch.Merge(latest_cf.get(), rocksdb::Slice(key.data(), account_size), latest_value);
+            if (batch.Count() >= 10'000) {
+                flush();
+            }
+        }
+        if (!iter->status().ok()) {
+            throw std::runtime_error(fmt::format("RocksDB latest state backfill failed: {}", iter->status().ToString()));
+        }
+        flush();
+    }
 };
 
 // --- Constructor & Destructor ---
-RocksDbImpl::RocksDbImpl(const std::filesystem::path& db_path) : pimpl_{std::make_unique<RocksDbPimpl>()} {
+RocksDbImpl::RocksDbImpl(const std::filesystem::path& db_path) : RocksDbImpl(db_path, RocksDBConfig{}) {}
+
+RocksDbImpl::RocksDbImpl(const std::filesystem::path& db_path, const RocksDBConfig& config)
+    : pimpl_{std::make_unique<RocksDbPimpl>(config)} {
     try {
         if (!std::filesystem::exists(db_path)) {
             std::filesystem::create_directories(db_path);
         }
 
-        // Configure RocksDB options for read-heavy workloads
-        pimpl_->options.create_if_missing = true;
-        pimpl_->options.max_open_files = 300;
-        pimpl_->options.write_buffer_size = 64 << 20; // 64MB
-        pimpl_->options.max_write_buffer_number = 3;
-        pimpl_->options.target_file_size_base = 64 << 20; // 64MB
+        // Configure RocksDB options from the shared config, tuned for the lookbacks
+        configure_prefix_seek(pimpl_->options, pimpl_->seek_options, config);
+        configure_history(pimpl_->options, config);
+
+        // Fails on a new database, which has no column family yet
+        std::vector<std::string> existing_cfs;
+        rocksdb::DB::ListColumnFamilies(pimpl_->options, db_path.string(), &existing_cfs);
+        const bool has_latest_cf =
+            std::find(existing_cfs.begin(), existing_cfs.end(), kLatestStateCf) != existing_cfs.end();
+        if (has_latest_cf && !config.latest_state_cf) {
+            // Writes would leave its versions behind the history
+            throw std::runtime_error("database has a latest_state column family, open it with latest_state_cf");
+        }
+
+        std::vector<rocksdb::ColumnFamilyDescriptor> descriptors{
+            rocksdb::ColumnFamilyDescriptor(rocksdb::kDefaultColumnFamilyName, pimpl_->options)};
+        if (config.latest_state_cf) {
+            descriptors.emplace_back(kLatestStateCf, latest_state_options(config, pimpl_->options));
+            pimpl_->options.create_missing_column_families = true;
+        }
 
         rocksdb::DB* raw_db = nullptr;
-        rocksdb::Status status = rocksdb::DB::Open(pimpl_->options, db_path.string(), &raw_db);
+        std::vector<rocksdb::ColumnFamilyHandle*> handles;
+        rocksdb::Status status = rocksdb::DB::Open(pimpl_->options, db_path.string(), descriptors, &handles, &raw_db);
 
         if (!status.ok()) {
             throw std::runtime_error(fmt::format("RocksDB initialization failed: {}", status.ToString()));
         }
 
         pimpl_->db.reset(raw_db);
+        pimpl_->history_cf.reset(handles[0]);
+        if (config.latest_state_cf) {
+            pimpl_->latest_cf.reset(handles[1]);
+            if (!has_latest_cf && !existing_cfs.empty()) {
+                pimpl_->backfill_latest();
+            }
+        }
         fmt::print("RocksDB database opened successfully at: {}\n", db_path.string());
     } catch (const std::exception& e) {
         throw std::runtime_error(fmt::format("RocksDB initialization failed: {}", e.what()));
@@ -48,65 +329,126 @@ RocksDbImpl::~RocksDbImpl() = default;
 
 // --- Public Methods ---
 void RocksDbImpl::put(std::span<const std::byte> key, std::span<const std::byte> value) {
-    rocksdb::Slice key_slice(reinterpret_cast<const char*>(key.data()), key.size());
-    rocksdb::Slice value_slice(reinterpret_cast<const char*>(value.data()), value.size());
-
-    rocksdb::Status status = pimpl_->db->Put(rocksdb::WriteOptions(), key_slice, value_slice);
+    utils::CompositeKey::check_length(key);
+    const auto& metrics = db_metrics();
+    const utils::ScopedLatency latency{metrics.put.latency};
+    rocksdb::Status status;
+    if (pimpl_->latest_cf) {
+        // Both column families are updated atomically
+        rocksdb::WriteBatch rocksdb_batch;
+        add_version(rocksdb_batch, pimpl_->history_cf.get(), pimpl_->latest_cf.get(), key, value);
+        status = pimpl_->db->Write(rocksdb::WriteOptions(), &rocksdb_batch);
+    } else {
+        rocksdb::Slice key_slice(reinterpret_cast<const char*>(key.data()), key.size());
+        rocksdb::Slice value_slice(reinterpret_cast<const char*>(value.data()), value.size());
+        status = pimpl_->db->Put(rocksdb::WriteOptions(), key_slice, value_slice);
+    }
 
     if (!status.ok()) {
         throw std::runtime_error(fmt::format("RocksDB put operation failed: {}", status.ToString()));
     }
+    metrics.count(metrics.put, 0, key.size() + value.size());
 }
 
-auto RocksDbImpl::get_state(std::string_view account_name, uint64_t block_number)
-    -> std::optional<std::vector<std::byte>> {
-
-    // 1. Create iterator
-    auto iter = std::unique_ptr<rocksdb::Iterator>(pimpl_->db->NewIterator(rocksdb::ReadOptions()));
+void RocksDbImpl::write(WriteBatch&& batch, Durability durability) {
+    if (batch.empty()) {
+        return;
+    }
 
-    // 2. Construct the target key: account_name + big_endian(block_number)
-    std::vector<std::byte> target_key;
-    target_key.reserve(account_name.length() + sizeof(uint64_t));
-    target_key.insert(target_key.end(),
-                      reinterpret_cast<const std::byte*>(account_name.data()),
-                      reinterpret_cast<const std::byte*>(account_name.data()) + account_name.length());
+    const auto& metrics = db_metrics();
+    const utils::ScopedLatency latency{metrics.write.latency};
+    const size_t copies = pimpl_->latest_cf ? 2 : 1;
+    rocksdb::WriteBatch rocksdb_batch(copies * (batch.byte_size() + batch.size() * 16));
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const auto [key, value] = batch[i];
+        utils::CompositeKey::check_length(key);
+        add_version(rocksdb_batch, pimpl_->history_cf.get(), pimpl_->latest_cf.get(), key, value);
+    }
 
-    const auto be_block = utils::to_big_endian_bytes(block_number);
-    target_key.insert(target_key.end(), be_block.begin(), be_block.end());
+    rocksdb::WriteOptions write_options;
+    write_options.sync = (durability == Durability::kSync);
+    rocksdb::Status status = pimpl_->db->Write(write_options, &rocksdb_batch);
 
-    rocksdb::Slice target_slice(reinterpret_cast<const char*>(target_key.data()), target_key.size());
+    if (!status.ok()) {
+        throw std::runtime_error(fmt::format("RocksDB write batch failed: {}", status.ToString()));
+    }
+    metrics.count(metrics.write, 0, batch.byte_size());
+}
 
-    // 3. Use SeekForPrev to find the largest key <= our target key
-    iter->SeekForPrev(target_slice);
+auto RocksDbImpl::get_state(std::string_view account_name, uint64_t block_number)
+    -> std::optional<std::vector<std::byte>> {
+    const auto& metrics = db_metrics();
+    const utils::ScopedLatency latency{metrics.get_state.latency};
 
-    if (!iter->Valid()) {
-        // No key found that is <= target_key, return nullopt
-        return std::nullopt;
+    // Queries at or after the latest version of the account need no lookback
+    if (pimpl_->latest_cf) {
+        auto latest = pimpl_->find_latest(account_name, block_number);
+        count_latest_state_lookup(latest.has_value());
+        if (latest) {
+            metrics.count(metrics.get_state, latest->size(), 0);
+            return latest;
+        }
     }
 
-    // 4. Validate that the found key belongs to the correct account
-    rocksdb::Slice found_key = iter->key();
-    std::string_view found_key_sv{found_key.data(), found_key.size()};
+    // Check out a pooled iterator, given back to the pool on every return path
+    const auto iter = pimpl_->iterators.acquire(*pimpl_->db, pimpl_->seek_options);
+    auto state = lookback(*iter, account_name, block_number);
+    metrics.count(metrics.get_state, state ? state->size() : 0, 0);
+    return state;
+}
 
-    // Check if the key starts with our account name and has enough bytes for the block number
-    if (found_key_sv.starts_with(account_name) &&
-        found_key_sv.length() == account_name.length() + sizeof(uint64_t)) {
+auto RocksDbImpl::get_states(std::span<const StateQuery> queries)
+    -> std::vector<std::optional<std::vector<std::byte>>> {
+    const auto& metrics = db_metrics();
+    const utils::ScopedLatency latency{metrics.get_states.latency};
 
-        // Extract the block number from the found key
-        const auto* block_bytes = reinterpret_cast<const std::byte*>(
-            found_key_sv.data() + account_name.length());
-        std::span<const std::byte, 8> block_span{block_bytes, 8};
-        uint64_t found_block = utils::from_big_endian_bytes(block_span);
+    // Seeking in key order keeps the iterator moving forward through the index and data blocks it already holds
+    std::vector<size_t> order(queries.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return std::tie(queries[a].account_name, queries[a].block_number) <
+               std::tie(queries[b].account_name, queries[b].block_number);
+    });
 
-        // Verify that the found block is <= requested block
-        if (found_block <= block_number) {
-            // 5. Return the value
-            rocksdb::Slice found_value = iter->value();
-            const auto* value_ptr = reinterpret_cast<const std::byte*>(found_value.data());
-            return std::vector<std::byte>{value_ptr, value_ptr + found_value.size()};
+    std::vector<std::optional<std::vector<std::byte>>> results(queries.size());
+    std::vector<size_t> lookbacks;
+    if (pimpl_->latest_cf) {
+        // One MultiGet resolves the queries at or after the latest version, the others fall back to lookbacks
+        std::vector<rocksdb::Slice> accounts;
+        accounts.reserve(order.size());
+        for (size_t index : order) {
+            accounts.emplace_back(queries[index].account_name.data(), queries[index].account_name.size());
         }
+        std::vector<rocksdb::PinnableSlice> latest(order.size());
+        std::vector<rocksdb::Status> statuses(order.size());
+        pimpl_->db->MultiGet(rocksdb::ReadOptions(), pimpl_->latest_cf.get(), accounts.size(), accounts.data(),
+                             latest.data(), statuses.data(), /*sorted_input=*/true);
+        for (size_t i = 0; i < order.size(); ++i) {
+            const size_t index = order[i];
+            if (statuses[i].ok()) {
+                results[index] = RocksDbPimpl::latest_if_visible(latest[i], queries[index].block_number);
+            } else if (!statuses[i].IsNotFound()) {
+                throw std::runtime_error(fmt::format("RocksDB latest state lookup failed: {}", statuses[i].ToString()));
+            }
+            count_latest_state_lookup(results[index].has_value());
+            if (!results[index]) {
+                lookbacks.push_back(index);
+            }
+        }
+    } else {
+        lookbacks = std::move(order);
     }
 
-    // 6. If no suitable key was found, return nullopt
-    return std::nullopt;
+    const auto iter = pimpl_->iterators.acquire(*pimpl_->db, pimpl_->seek_options);
+    for (size_t index : lookbacks) {
+        results[index] = lookback(*iter, queries[index].account_name, queries[index].block_number);
+    }
+    if (utils::metrics_enabled()) {
+        uint64_t bytes = 0;
+        for (const auto& result : results) {
+            bytes += result ? result->size() : 0;
+        }
+        metrics.count(metrics.get_states, bytes, 0);
+    }
+    return results;
 }
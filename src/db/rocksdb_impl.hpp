@@ -1,6 +1,7 @@
 #pragma once
 
 #include "db/interface.hpp"
+#include "db/rocksdb_config.hpp"
 
 #include <filesystem>
 #include <memory>
@@ -20,6 +21,11 @@ public:
      */
     explicit RocksDbImpl(const std::filesystem::path& db_path);
 
+    /**
+     * @brief Constructs a RocksDbImpl object tuned by the given config, whose path is ignored in favour of db_path.
+     */
+    RocksDbImpl(const std::filesystem::path& db_path, const RocksDBConfig& config);
+
     ~RocksDbImpl() override;
 
     // Deleted copy and move constructors/assignments to ensure unique ownership of the database.
@@ -30,9 +36,17 @@ public:
 
     void put(std::span<const std::byte> key, std::span<const std::byte> value) override;
 
+    void write(WriteBatch&& batch, Durability durability) override;
+
     auto get_state(std::string_view account_name, uint64_t block_number)
         -> std::optional<std::vector<std::byte>> override;
 
+    /**
+     * @brief Resolves the queries in key order through one iterator, so neighbouring lookbacks share the blocks read.
+     */
+    auto get_states(std::span<const StateQuery> queries)
+        -> std::vector<std::optional<std::vector<std::byte>>> override;
+
 private:
     // PImpl idiom to hide RocksDB implementation details from the header.
     struct RocksDbPimpl;
@@ -0,0 +1,93 @@
+#include "db/rocksdb_iterator_pool.hpp"
+#include "db/db_metrics.hpp"
+
+namespace {
+
+// Lookbacks served by a pooled iterator, the others create one
+void count_iterator_pool_lookup(bool hit) {
+    if (!utils::metrics_enabled()) {
+        return;
+    }
+    static utils::Counter& hits = DbMetrics::cache("rocksdb", "iterator_pool", /*hit=*/true);
+    static utils::Counter& misses = DbMetrics::cache("rocksdb", "iterator_pool", /*hit=*/false);
+    (hit ? hits : misses).add();
+}
+
+} // namespace
+
+IteratorPool::IteratorPool(const RocksDBConfig& config)
+    : staleness_{std::chrono::milliseconds{config.iterator_staleness_ms}},
+      max_age_{std::chrono::milliseconds{config.iterator_max_age_ms}},
+      capacity_{config.iterator_pool_size} {}
+
+auto IteratorPool::acquire(rocksdb::DB& db, const rocksdb::ReadOptions& read_options) -> Lease {
+    const auto now = Clock::now();
+    Entry entry;
+    std::vector<Entry> expired;  // Destroyed after the lock is released, releasing what they pin
+    {
+        std::lock_guard lock{mutex_};
+        take_expired(now, expired);
+        if (!idle_.empty()) {
+            entry = std::move(idle_.back());
+            idle_.pop_back();
+        }
+        update_idle_gauge();
+    }
+    if (entry.iterator && now - entry.refreshed_at >= staleness_) {
+        if (entry.iterator->Refresh().ok()) {
+            entry.refreshed_at = now;
+        } else {
+            entry.iterator.reset();
+        }
+    }
+    count_iterator_pool_lookup(entry.iterator != nullptr);
+    if (!entry.iterator) {
+        entry.iterator.reset(db.NewIterator(read_options));
+        entry.created_at = now;
+        entry.refreshed_at = now;
+    }
+    return Lease{*this, std::move(entry)};
+}
+
+auto IteratorPool::idle_size() -> size_t {
+    std::lock_guard lock{mutex_};
+    return idle_.size();
+}
+
+void IteratorPool::release(Entry entry) {
+    const auto now = Clock::now();
+    std::vector<Entry> expired;
+    if (!entry.iterator || !entry.iterator->status().ok() || now - entry.created_at >= max_age_) {
+        expired.push_back(std::move(entry));
+    }
+    std::lock_guard lock{mutex_};
+    take_expired(now, expired);
+    if (entry.iterator && idle_.size() < capacity_) {
+        idle_.push_back(std::move(entry));
+    }
+    update_idle_gauge();
+}
+
+void IteratorPool::take_expired(Clock::time_point now, std::vector<Entry>& expired) {
+    auto kept = idle_.begin();
+    for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+        if (now - it->created_at >= max_age_) {
+            expired.push_back(std::move(*it));
+        } else {
+            if (kept != it) {
+                *kept = std::move(*it);
+            }
+            ++kept;
+        }
+    }
+    idle_.erase(kept, idle_.end());
+}
+
+void IteratorPool::update_idle_gauge() const {
+    if (!utils::metrics_enabled()) {
+        return;
+    }
+    static utils::Gauge& idle = utils::MetricsRegistry::instance().gauge(
+        "rocksdb_iterator_pool_idle", "", "Idle iterators kept by the lookback iterator pool");
+    idle.set(static_cast<int64_t>(idle_.size()));
+}
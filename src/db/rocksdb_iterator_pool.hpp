@@ -0,0 +1,80 @@
+#pragma once
+
+#include "db/rocksdb_config.hpp"
+
+#include <rocksdb/db.h>
+#include <rocksdb/iterator.h>
+#include <rocksdb/options.h>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Idle lookback iterators of RocksDbImpl, checked out by one thread at a time.
+ *
+ * An iterator pins the memtables and SST files of the version it was created or refreshed on, so pooled iterators
+ * are refreshed once older than RocksDBConfig::iterator_staleness_ms, whoever wrote since, and recreated past
+ * iterator_max_age_ms. Every acquire and release drops all the idle iterators past max_age, not only the one
+ * handed out: after a burst of readers, the iterators a single thread no longer reaches do not pin obsolete files
+ * and blocks forever.
+ */
+class IteratorPool {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::unique_ptr<rocksdb::Iterator> iterator;
+        Clock::time_point created_at;
+        Clock::time_point refreshed_at;
+    };
+
+    /**
+     * @brief Checked out iterator, given back to the pool when the lease goes out of scope.
+     */
+    class Lease {
+    public:
+        Lease(IteratorPool& pool, Entry entry) : pool_{pool}, entry_{std::move(entry)} {}
+        ~Lease() { pool_.release(std::move(entry_)); }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        rocksdb::Iterator* operator->() const { return entry_.iterator.get(); }
+        rocksdb::Iterator& operator*() const { return *entry_.iterator; }
+
+    private:
+        IteratorPool& pool_;
+        Entry entry_;
+    };
+
+    explicit IteratorPool(const RocksDBConfig& config);
+
+    IteratorPool(const IteratorPool&) = delete;
+    IteratorPool& operator=(const IteratorPool&) = delete;
+
+    /**
+     * @brief Checks out an idle iterator, refreshed if stale, or a new one created with read_options.
+     */
+    auto acquire(rocksdb::DB& db, const rocksdb::ReadOptions& read_options) -> Lease;
+
+    /**
+     * @brief Returns the number of idle iterators kept.
+     */
+    auto idle_size() -> size_t;
+
+private:
+    void release(Entry entry);
+
+    // Moves the idle entries past max_age to expired, keeping the order of the others
+    void take_expired(Clock::time_point now, std::vector<Entry>& expired);
+    void update_idle_gauge() const;
+
+    const Clock::duration staleness_;
+    const Clock::duration max_age_;
+    const size_t capacity_;
+    std::mutex mutex_;
+    std::vector<Entry> idle_;  // Most recently released last
+};
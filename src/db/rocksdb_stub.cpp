@@ -10,15 +10,32 @@ RocksDbImpl::RocksDbImpl(const std::filesystem::path& db_path) {
     throw std::runtime_error("RocksDB support not compiled in");
 }
 
+RocksDbImpl::RocksDbImpl(const std::filesystem::path& db_path, const RocksDBConfig& config) {
+    throw std::runtime_error("RocksDB support not compiled in");
+}
+
 RocksDbImpl::~RocksDbImpl() = default;
 
 void RocksDbImpl::put(std::span<const std::byte> key, std::span<const std::byte> value) {
     throw std::runtime_error("RocksDB support not compiled in");
 }
 
+void RocksDbImpl::write(WriteBatch&& batch, Durability durability) {
+    throw std::runtime_error("RocksDB support not compiled in");
+}
+
 auto RocksDbImpl::get_state(std::string_view account_name, uint64_t block_number)
     -> std::optional<std::vector<std::byte>> {
     throw std::runtime_error("RocksDB support not compiled in");
 }
 
+auto RocksDbImpl::get_states(std::span<const StateQuery> queries)
+    -> std::vector<std::optional<std::vector<std::byte>>> {
+    throw std::runtime_error("RocksDB support not compiled in");
+}
+
+void apply_rocksdb_config(const RocksDBConfig& config, rocksdb::Options& options) {
+    throw std::runtime_error("RocksDB support not compiled in");
+}
+
 #endif
@@ -0,0 +1,295 @@
+#include "db/value_codec.hpp"
+#include "utils/history_chunk.hpp"
+#include "utils/simd_compare.hpp"
+
+#include <climits>
+#include <stdexcept>
+#include <utility>
+
+#ifndef HAVE_LZ4
+#define HAVE_LZ4 0
+#endif
+
+#ifndef HAVE_ZSTD
+#define HAVE_ZSTD 0
+#endif
+
+#if HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#if HAVE_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+namespace {
+
+#if HAVE_ZSTD
+// Decompression contexts are per thread so that readers decode concurrently without locking
+auto thread_dctx() -> ZSTD_DCtx* {
+    thread_local const std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx{ZSTD_createDCtx(), &ZSTD_freeDCtx};
+    return dctx.get();
+}
+#endif
+
+void append_raw(std::vector<std::byte>& out, std::span<const std::byte> value) {
+    out.clear();
+    out.reserve(1 + value.size());
+    out.push_back(static_cast<std::byte>(ValueCodec::Format::kRaw));
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+} // namespace
+
+struct ValueCodec::Impl {
+    ValueCodecOptions options;
+    std::vector<std::byte> dictionary;
+#if HAVE_ZSTD
+    ZSTD_CCtx* cctx{nullptr};
+    ZSTD_CDict* cdict{nullptr};
+    std::atomic<ZSTD_DDict*> ddict{nullptr};  // Set once, read by concurrent decoders
+    std::vector<std::byte> samples;
+    std::vector<size_t> sample_sizes;
+    bool training_done{false};
+
+    ~Impl() {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict.load());
+        ZSTD_freeCCtx(cctx);
+    }
+
+    void install_dictionary(std::vector<std::byte> bytes) {
+        dictionary = std::move(bytes);
+        cdict = ZSTD_createCDict(dictionary.data(), dictionary.size(), options.zstd_level);
+        ddict.store(ZSTD_createDDict(dictionary.data(), dictionary.size()), std::memory_order_release);
+        if (cdict == nullptr || ddict.load(std::memory_order_relaxed) == nullptr) {
+            throw std::runtime_error("ValueCodec: invalid zstd dictionary");
+        }
+        training_done = true;
+        samples = {};
+        sample_sizes = {};
+    }
+
+    // Collects the value as a training sample, training the dictionary once enough have been seen.
+    // zstd advises about 100x the dictionary size of samples, more only slows training down.
+    void sample(std::span<const std::byte> value) {
+        if (training_done || options.dictionary_sample_count == 0) {
+            return;
+        }
+        samples.insert(samples.end(), value.begin(), value.end());
+        sample_sizes.push_back(value.size());
+        if (sample_sizes.size() < options.dictionary_sample_count && samples.size() < 100 * options.dictionary_size) {
+            return;
+        }
+        std::vector<std::byte> trained(options.dictionary_size);
+        const size_t size = ZDICT_trainFromBuffer(trained.data(), trained.size(), samples.data(), sample_sizes.data(),
+                                                  static_cast<unsigned>(sample_sizes.size()));
+        if (ZDICT_isError(size)) {
+            // Too few or too uniform samples: keep compressing without a dictionary
+            training_done = true;
+            samples = {};
+            sample_sizes = {};
+            return;
+        }
+        trained.resize(size);
+        install_dictionary(std::move(trained));
+    }
+
+    void compress(std::span<const std::byte> value, std::vector<std::byte>& out) {
+        const auto format = cdict != nullptr ? Format::kZstdDict : Format::kZstd;
+        out.resize(1 + ZSTD_compressBound(value.size()));
+        out[0] = static_cast<std::byte>(format);
+        const size_t written =
+            cdict != nullptr
+                ? ZSTD_compress_usingCDict(cctx, out.data() + 1, out.size() - 1, value.data(), value.size(), cdict)
+                : ZSTD_compressCCtx(cctx, out.data() + 1, out.size() - 1, value.data(), value.size(),
+                                    options.zstd_level);
+        if (ZSTD_isError(written)) {
+            out.clear();
+            return;
+        }
+        out.resize(1 + written);
+    }
+
+    auto decompress(Format format, std::span<const std::byte> payload) const -> std::vector<std::byte> {
+        const unsigned long long size = ZSTD_getFrameContentSize(payload.data(), payload.size());
+        if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN) {
+            throw std::runtime_error("ValueCodec: invalid zstd frame");
+        }
+        std::vector<std::byte> out(static_cast<size_t>(size));
+        size_t written = 0;
+        if (format == Format::kZstdDict) {
+            const ZSTD_DDict* dict = ddict.load(std::memory_order_acquire);
+            if (dict == nullptr) {
+                throw std::runtime_error("ValueCodec: value compressed with a dictionary that is not loaded");
+            }
+            written = ZSTD_decompress_usingDDict(thread_dctx(), out.data(), out.size(), payload.data(), payload.size(),
+                                                 dict);
+        } else {
+            written = ZSTD_decompressDCtx(thread_dctx(), out.data(), out.size(), payload.data(), payload.size());
+        }
+        if (ZSTD_isError(written) || written != out.size()) {
+            throw std::runtime_error("ValueCodec: corrupt zstd value");
+        }
+        return out;
+    }
+#endif
+
+#if HAVE_LZ4
+    static void compress_lz4(std::span<const std::byte> value, std::vector<std::byte>& out) {
+        out.clear();
+        out.push_back(static_cast<std::byte>(Format::kLz4));
+        utils::append_varint(out, value.size());
+        const size_t header = out.size();
+        const int bound = LZ4_compressBound(static_cast<int>(value.size()));
+        out.resize(header + static_cast<size_t>(bound));
+        const int written = LZ4_compress_default(reinterpret_cast<const char*>(value.data()),
+                                                 reinterpret_cast<char*>(out.data() + header),
+                                                 static_cast<int>(value.size()), bound);
+        if (written <= 0) {
+            out.clear();
+            return;
+        }
+        out.resize(header + static_cast<size_t>(written));
+    }
+
+    static auto decompress_lz4(std::span<const std::byte> payload) -> std::vector<std::byte> {
+        const uint64_t size = utils::read_varint(payload);
+        if (size > INT_MAX || payload.size() > INT_MAX) {
+            throw std::runtime_error("ValueCodec: corrupt LZ4 value");
+        }
+        std::vector<std::byte> out(static_cast<size_t>(size));
+        const int written = LZ4_decompress_safe(reinterpret_cast<const char*>(payload.data()),
+                                                reinterpret_cast<char*>(out.data()), static_cast<int>(payload.size()),
+                                                static_cast<int>(size));
+        if (written < 0 || static_cast<uint64_t>(written) != size) {
+            throw std::runtime_error("ValueCodec: corrupt LZ4 value");
+        }
+        return out;
+    }
+#endif
+};
+
+ValueCodec::ValueCodec(const ValueCodecOptions& options) : impl_{std::make_unique<Impl>()} {
+    impl_->options = options;
+    if (options.compression == ValueCompression::kLz4 && !HAVE_LZ4) {
+        throw std::invalid_argument("ValueCodec: LZ4 support not compiled in (ENABLE_LZ4)");
+    }
+    if (options.compression == ValueCompression::kZstd && !HAVE_ZSTD) {
+        throw std::invalid_argument("ValueCodec: zstd support not compiled in (ENABLE_ZSTD)");
+    }
+#if HAVE_ZSTD
+    if (options.compression == ValueCompression::kZstd) {
+        impl_->cctx = ZSTD_createCCtx();
+        if (impl_->cctx == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+#endif
+}
+
+ValueCodec::~ValueCodec() = default;
+
+auto ValueCodec::encode(std::span<const std::byte> value) -> std::vector<std::byte> {
+    std::vector<std::byte> out;
+    if (value.size() >= impl_->options.min_compress_size && value.size() <= INT_MAX) {
+        switch (impl_->options.compression) {
+            case ValueCompression::kNone:
+                break;
+            case ValueCompression::kLz4:
+#if HAVE_LZ4
+                Impl::compress_lz4(value, out);
+#endif
+                break;
+            case ValueCompression::kZstd:
+#if HAVE_ZSTD
+                impl_->sample(value);
+                impl_->compress(value, out);
+#endif
+                break;
+        }
+    }
+    // Keep the value raw unless compression actually saves space
+    if (out.empty() || out.size() >= 1 + value.size()) {
+        append_raw(out, value);
+    }
+    return out;
+}
+
+auto ValueCodec::decode(std::span<const std::byte> stored) const -> std::vector<std::byte> {
+    const Format format = format_of(stored);
+    const auto payload = stored.subspan(1);
+    switch (format) {
+        case Format::kRaw:
+            return {payload.begin(), payload.end()};
+        case Format::kLz4:
+#if HAVE_LZ4
+            return Impl::decompress_lz4(payload);
+#else
+            throw std::runtime_error("ValueCodec: LZ4 value but LZ4 support not compiled in");
+#endif
+        case Format::kZstd:
+        case Format::kZstdDict:
+#if HAVE_ZSTD
+            return impl_->decompress(format, payload);
+#else
+            throw std::runtime_error("ValueCodec: zstd value but zstd support not compiled in");
+#endif
+    }
+    throw std::runtime_error("ValueCodec: unknown value header");
+}
+
+auto ValueCodec::format_of(std::span<const std::byte> stored) -> Format {
+    if (stored.empty()) {
+        throw std::runtime_error("ValueCodec: empty value, missing header byte");
+    }
+    return static_cast<Format>(stored[0]);
+}
+
+void ValueCodec::load_dictionary([[maybe_unused]] std::span<const std::byte> dictionary) {
+    if (!impl_->dictionary.empty()) {
+        throw std::runtime_error("ValueCodec: dictionary already set");
+    }
+#if HAVE_ZSTD
+    impl_->install_dictionary({dictionary.begin(), dictionary.end()});
+#else
+    throw std::runtime_error("ValueCodec: zstd support not compiled in, cannot load a dictionary");
+#endif
+}
+
+auto ValueCodec::dictionary() const -> std::span<const std::byte> { return impl_->dictionary; }
+
+// --- HotValueCache ---
+auto HotValueCache::find(std::span<const std::byte> key, std::span<const std::byte> stored) -> Value {
+    const std::string_view key_view{reinterpret_cast<const char*>(key.data()), key.size()};
+    std::lock_guard lock{mutex_};
+    const auto it = index_.find(key_view);
+    if (it == index_.end() || !utils::bytes_equal(it->second->stored, stored)) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return it->second->value;
+}
+
+void HotValueCache::insert(std::span<const std::byte> key, std::span<const std::byte> stored, Value value) {
+    if (capacity_ == 0) {
+        return;
+    }
+    const std::string_view key_view{reinterpret_cast<const char*>(key.data()), key.size()};
+    std::lock_guard lock{mutex_};
+    if (const auto it = index_.find(key_view); it != index_.end()) {
+        it->second->stored.assign(stored.begin(), stored.end());
+        it->second->value = std::move(value);
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+    if (lru_.size() >= capacity_) {
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+    lru_.push_front(Node{std::string{key_view}, {stored.begin(), stored.end()}, std::move(value)});
+    index_.emplace(lru_.front().key, lru_.begin());
+}
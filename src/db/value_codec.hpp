@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Compression applied to the values of a table.
+ */
+enum class ValueCompression {
+    kNone,  // Values are stored as is, without a header byte
+    kLz4,   // LZ4: fastest decompression, moderate ratio (requires ENABLE_LZ4)
+    kZstd,  // Zstandard with a dictionary trained on the first values written (requires ENABLE_ZSTD)
+};
+
+struct ValueCodecOptions {
+    ValueCompression compression{ValueCompression::kNone};
+    int zstd_level{3};
+    size_t min_compress_size{32};           // Smaller values are stored raw, compression would not pay off
+    size_t dictionary_sample_count{1024};   // Values sampled to train the zstd dictionary, 0 to not use one
+    size_t dictionary_size{16 * 1024};      // Maximum size of the trained zstd dictionary
+};
+
+/**
+ * @brief Encodes table values as `header byte + payload`, the header telling how the payload is stored.
+ *
+ * The header makes every value self-describing, so a table can mix raw, LZ4 and zstd values: values that
+ * do not shrink are kept raw, values written before the dictionary is trained stay plain zstd, and the
+ * compression of a table can be changed without rewriting it.
+ *
+ * With kZstd the first dictionary_sample_count values are sampled (and stored plain zstd meanwhile), then
+ * a dictionary is trained from them with ZDICT_trainFromBuffer. Small values of similar shape (JSON
+ * account states, RLP) compress far better with a dictionary than alone. The trained dictionary must be
+ * persisted by the owner (see dictionary()) and loaded back with load_dictionary() when reopening.
+ *
+ * encode() is meant to be called by one writer at a time; decode() is safe to call concurrently.
+ */
+class ValueCodec {
+public:
+    enum class Format : uint8_t {
+        kRaw = 0,
+        kLz4 = 1,       // Followed by varint(raw size) and an LZ4 block
+        kZstd = 2,      // Followed by a zstd frame
+        kZstdDict = 3,  // Followed by a zstd frame compressed with the table dictionary
+    };
+
+    /**
+     * @throws std::invalid_argument if the requested compression was not compiled in.
+     */
+    explicit ValueCodec(const ValueCodecOptions& options);
+    ~ValueCodec();
+
+    ValueCodec(const ValueCodec&) = delete;
+    ValueCodec& operator=(const ValueCodec&) = delete;
+
+    auto encode(std::span<const std::byte> value) -> std::vector<std::byte>;
+
+    /**
+     * @throws std::runtime_error if stored is corrupt or uses a compression that was not compiled in.
+     */
+    auto decode(std::span<const std::byte> stored) const -> std::vector<std::byte>;
+
+    /**
+     * @throws std::runtime_error if stored is empty.
+     */
+    static auto format_of(std::span<const std::byte> stored) -> Format;
+
+    /**
+     * @brief Installs a dictionary previously returned by dictionary(), e.g. read back from the database.
+     * @throws std::runtime_error if the codec already has a dictionary.
+     */
+    void load_dictionary(std::span<const std::byte> dictionary);
+
+    /**
+     * @brief Returns the current zstd dictionary, empty until trained or loaded.
+     */
+    auto dictionary() const -> std::span<const std::byte>;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Bounded LRU cache of decompressed values of hot keys.
+ *
+ * Entries keep a copy of the stored (compressed) bytes they were decoded from and only hit when the
+ * bytes read from the current snapshot are identical, so a cached value can never be stale under MVCC
+ * and writers need not invalidate anything. Comparing the stored bytes is much cheaper than decompressing.
+ */
+class HotValueCache {
+public:
+    using Value = std::shared_ptr<const std::vector<std::byte>>;
+
+    explicit HotValueCache(size_t capacity) : capacity_{capacity} {}
+
+    /**
+     * @return The value decoded from stored for key, or nullptr on a miss.
+     */
+    auto find(std::span<const std::byte> key, std::span<const std::byte> stored) -> Value;
+
+    void insert(std::span<const std::byte> key, std::span<const std::byte> stored, Value value);
+
+    auto hits() const -> uint64_t { return hits_.load(std::memory_order_relaxed); }
+    auto misses() const -> uint64_t { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    struct Node {
+        std::string key;
+        std::vector<std::byte> stored;
+        Value value;
+    };
+
+    size_t capacity_;
+    std::mutex mutex_;
+    std::list<Node> lru_;  // Most recently used first
+    std::unordered_map<std::string_view, std::list<Node>::iterator> index_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief How far a committed write must have reached before IDatabase::write returns.
+ */
+enum class Durability {
+    kSync,    // Flushed to stable storage: survives a power loss
+    kNoSync,  // Handed to the OS without flushing: survives a process crash, not a power loss
+};
+
+/**
+ * @brief Backend-neutral set of puts applied atomically by IDatabase::write.
+ *
+ * Keys and values are copied into a single append-only arena, so building a batch costs one
+ * allocation per arena growth instead of two per entry. Entries are exposed as spans into the arena,
+ * valid until the batch is modified.
+ */
+class WriteBatch {
+public:
+    struct Entry {
+        std::span<const std::byte> key;
+        std::span<const std::byte> value;
+    };
+
+    WriteBatch() = default;
+
+    WriteBatch(WriteBatch&&) noexcept = default;
+    WriteBatch& operator=(WriteBatch&&) noexcept = default;
+    WriteBatch(const WriteBatch&) = delete;
+    WriteBatch& operator=(const WriteBatch&) = delete;
+
+    /**
+     * @brief Pre-allocates room for the given number of entries and key/value bytes.
+     */
+    void reserve(size_t entries, size_t bytes) {
+        records_.reserve(entries);
+        arena_.reserve(bytes);
+    }
+
+    /**
+     * @brief Appends a put. When a key is put several times the last value wins.
+     * @throws std::length_error if the key or the value exceed 4 GiB.
+     */
+    void put(std::span<const std::byte> key, std::span<const std::byte> value) {
+        if (key.size() > UINT32_MAX || value.size() > UINT32_MAX) {
+            throw std::length_error("WriteBatch: key or value too large");
+        }
+        records_.push_back(Record{arena_.size(), static_cast<uint32_t>(key.size()), static_cast<uint32_t>(value.size())});
+        arena_.insert(arena_.end(), key.begin(), key.end());
+        arena_.insert(arena_.end(), value.begin(), value.end());
+    }
+
+    auto operator[](size_t index) const -> Entry {
+        const Record& record = records_[index];
+        const std::byte* key = arena_.data() + record.offset;
+        return Entry{{key, record.key_size}, {key + record.key_size, record.value_size}};
+    }
+
+    auto size() const -> size_t { return records_.size(); }
+    auto empty() const -> bool { return records_.empty(); }
+
+    /**
+     * @brief Total bytes of keys and values held by the batch.
+     */
+    auto byte_size() const -> size_t { return arena_.size(); }
+
+    void clear() {
+        records_.clear();
+        arena_.clear();
+    }
+
+    /**
+     * @brief Orders the entries by key (bytewise), keeping puts of the same key in insertion order
+     * so that applying them in sequence still lets the last one win.
+     */
+    void sort_by_key() {
+        std::ranges::stable_sort(records_, [this](const Record& lhs, const Record& rhs) {
+            return std::ranges::lexicographical_compare(key_of(lhs), key_of(rhs));
+        });
+    }
+
+private:
+    struct Record {
+        size_t offset;  // Key bytes start here, immediately followed by the value bytes
+        uint32_t key_size;
+        uint32_t value_size;
+    };
+
+    auto key_of(const Record& record) const -> std::span<const std::byte> {
+        return {arena_.data() + record.offset, record.key_size};
+    }
+
+    std::vector<std::byte> arena_;
+    std::vector<Record> records_;
+};
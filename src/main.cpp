@@ -40,6 +40,13 @@ int main() {
             engine.set_account_state("vitalik", 1, R"({"balance": "100", "nonce": "0"})");
             engine.set_account_state("vitalik", 5, R"({"balance": "50", "nonce": "1"})");
             engine.set_account_state("vitalik", 100, R"({"balance": "200", "nonce": "2"})");
+
+            // A whole block of account changes is committed atomically in one write
+            const AccountStateChange block_150[] = {
+                {"vitalik", R"({"balance": "180", "nonce": "3"})"},
+                {"satoshi", R"({"balance": "1000", "nonce": "0"})"},
+            };
+            engine.import_block(150, block_150, Durability::kNoSync);
             fmt::print("MDBX population complete.\n\n");
 
             // --- Queries ---
@@ -51,6 +58,40 @@ int main() {
             perform_query(engine, "vitalik", 1);
             perform_query(engine, "vitalik", 0);
             perform_query(engine, "satoshi", 100);
+            perform_query(engine, "vitalik", 200);
+            perform_query(engine, "satoshi", 150);
+        }
+
+        fmt::print("Testing MDBX implementation with history chunks...\n");
+        {
+            auto db = std::make_unique<MdbxImpl>(mdbx_db_path, MdbxLayout::kHistoryChunks);
+            QueryEngine engine(std::move(db));
+
+            // --- Data Population ---
+            fmt::print("Populating MDBX (history chunks) database with sample data for account 'vitalik'...\n");
+            engine.set_account_state("vitalik", 1, R"({"balance": "100", "nonce": "0"})");
+            engine.set_account_state("vitalik", 5, R"({"balance": "50", "nonce": "1"})");
+            engine.set_account_state("vitalik", 100, R"({"balance": "200", "nonce": "2"})");
+
+            // A whole block of account changes is committed atomically in one write
+            const AccountStateChange block_150[] = {
+                {"vitalik", R"({"balance": "180", "nonce": "3"})"},
+                {"satoshi", R"({"balance": "1000", "nonce": "0"})"},
+            };
+            engine.import_block(150, block_150, Durability::kNoSync);
+            fmt::print("MDBX (history chunks) population complete.\n\n");
+
+            // --- Queries ---
+            fmt::print("--- MDBX HISTORY CHUNK QUERIES ---\n");
+            perform_query(engine, "vitalik", 100);
+            perform_query(engine, "vitalik", 50);
+            perform_query(engine, "vitalik", 80);
+            perform_query(engine, "vitalik", 4);
+            perform_query(engine, "vitalik", 1);
+            perform_query(engine, "vitalik", 0);
+            perform_query(engine, "satoshi", 100);
+            perform_query(engine, "vitalik", 200);
+            perform_query(engine, "satoshi", 150);
         }
 
 #if HAVE_ROCKSDB
@@ -64,6 +105,13 @@ int main() {
             engine.set_account_state("vitalik", 1, R"({"balance": "100", "nonce": "0"})");
             engine.set_account_state("vitalik", 5, R"({"balance": "50", "nonce": "1"})");
             engine.set_account_state("vitalik", 100, R"({"balance": "200", "nonce": "2"})");
+
+            // A whole block of account changes is committed atomically in one write
+            const AccountStateChange block_150[] = {
+                {"vitalik", R"({"balance": "180", "nonce": "3"})"},
+                {"satoshi", R"({"balance": "1000", "nonce": "0"})"},
+            };
+            engine.import_block(150, block_150, Durability::kNoSync);
             fmt::print("RocksDB population complete.\n\n");
 
             // --- Queries ---
@@ -75,6 +123,8 @@ int main() {
             perform_query(engine, "vitalik", 1);
             perform_query(engine, "vitalik", 0);
             perform_query(engine, "satoshi", 100);
+            perform_query(engine, "vitalik", 200);
+            perform_query(engine, "satoshi", 150);
         }
 #else
         fmt::print("RocksDB not available, skipping RocksDB tests...\n");
@@ -1,4 +1,8 @@
 #include "db/mdbx.hpp"
+#include "db/mdbx_fast_cursor.hpp"
+#include "db/mdbx_heatmap.hpp"
+#include "db/mdbx_warmer.hpp"
+#include "utils/metrics.hpp"
 #include "utils/string_utils.hpp"
 #include "mdbx_bench_util.hpp"
 #include <fmt/format.h>
@@ -8,6 +12,11 @@
 #include <cassert>
 #include <cstring>
 #include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace datastore::kvdb;
 using namespace utils;
@@ -41,12 +50,12 @@ void populate_database(::mdbx::env_managed& env, const BenchConfig& config) {
         
         {
             RWTxnManaged rw_txn(env);
-            auto cursor = rw_txn.rw_cursor(table_config);
+            FastCursor<> cursor{rw_txn, table_config};
             
             for (size_t i = batch_start; i < batch_end; ++i) {
                 std::string key = generate_key(i);
                 std::string value = generate_value(i);
-                cursor->insert(str_to_slice(key), str_to_slice(value));
+                cursor.insert(str_to_slice(key), str_to_slice(value));
             }
             
             auto commit_start = std::chrono::high_resolution_clock::now();
@@ -100,26 +109,54 @@ RoundResult perform_read_test(::mdbx::env_managed& env, size_t round_number, con
     fmt::println("Reading {} randomly selected KV pairs", config.test_kv_pairs);
     auto read_start = std::chrono::high_resolution_clock::now();
     
-    ctx.result.read_latencies_us.reserve(config.test_kv_pairs);
-    
-    {
+    if (config.read_prefetch_threads > 0) {
+        // Batched mode: keys are resolved in sorted order while helper readers prefetch the upcoming pages. The gaps
+        // between results are not per-lookup latencies comparable with the serial loop, only throughput is reported
+        ctx.result.throughput_only = true;
+        fmt::println("Using batched reads: {} prefetch threads, distance {}",
+                     config.read_prefetch_threads, config.read_prefetch_distance);
+
+        std::vector<std::string> keys;
+        keys.reserve(ctx.test_indices.size());
+        for (size_t index : ctx.test_indices) {
+            keys.push_back(generate_key(index));
+        }
+        std::vector<ByteView> key_views;
+        key_views.reserve(keys.size());
+        for (const auto& key : keys) {
+            key_views.push_back(str_to_byteview(key));
+        }
+
         ROTxnManaged ro_txn(env);
         MapConfig table_config{"bench_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
-        auto cursor = ro_txn.ro_cursor(table_config);
-        
+        BatchFindOptions options{
+            .prefetch_distance = config.read_prefetch_distance,
+            .prefetch_threads = config.read_prefetch_threads,
+        };
+
+        ctx.result.successful_reads = find_batch(ro_txn, table_config, key_views,
+            [](size_t, const CursorResult&) {}, options);
+
+        ro_txn.abort();
+    } else {
+        ctx.result.read_latencies_us.reserve(config.test_kv_pairs);
+        ROTxnManaged ro_txn(env);
+        MapConfig table_config{"bench_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+        FastCursor<> cursor{ro_txn, table_config};
+
         for (size_t index : ctx.test_indices) {
             std::string key = generate_key(index);
-            
+
             double latency_us = measure_operation_us([&]() {
-                auto find_result = cursor->find(str_to_slice(key), false);
+                auto find_result = cursor.find(str_to_slice(key), false);
                 if (find_result.done) {
                     ctx.result.successful_reads++;
                 }
             });
-            
+
             ctx.result.read_latencies_us.push_back(latency_us);
         }
-        
+
         ro_txn.abort();
     }
     
@@ -130,8 +167,10 @@ RoundResult perform_read_test(::mdbx::env_managed& env, size_t round_number, con
     calculate_latency_stats(ctx.result);
     
     fmt::println("✓ Read {} KV pairs in {:.2f} ms", ctx.result.successful_reads, ctx.result.read_time_ms);
-    fmt::println("✓ Average read latency: {:.2f} μs", ctx.result.avg_read_latency_us);
-    fmt::println("✓ Tp99 read latency: {:.2f} μs", ctx.result.tp99_read_latency_us);
+    if (!ctx.result.throughput_only) {
+        fmt::println("✓ Average read latency: {:.2f} μs", ctx.result.avg_read_latency_us);
+        fmt::println("✓ Tp99 read latency: {:.2f} μs", ctx.result.tp99_read_latency_us);
+    }
     fmt::println("✓ Read throughput: {:.2f} ops/sec", 
                  static_cast<double>(ctx.result.successful_reads) / (ctx.result.read_time_ms / 1000.0));
     
@@ -149,7 +188,7 @@ RoundResult perform_write_test(::mdbx::env_managed& env, size_t round_number, co
     {
         RWTxnManaged rw_txn(env);
         MapConfig table_config{"bench_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
-        auto cursor = rw_txn.rw_cursor(table_config);
+        FastCursor<> cursor{rw_txn, table_config};
         
         auto write_start = std::chrono::high_resolution_clock::now();
         
@@ -159,7 +198,7 @@ RoundResult perform_write_test(::mdbx::env_managed& env, size_t round_number, co
             std::string new_value = generate_value(index + round_number * 1000000);
             
             double latency_us = measure_operation_us([&]() {
-                cursor->upsert(str_to_slice(key), str_to_slice(new_value));
+                cursor.upsert(str_to_slice(key), str_to_slice(new_value));
                 ctx.result.successful_writes++;
             });
             
@@ -201,13 +240,13 @@ RoundResult perform_update_test(::mdbx::env_managed& env, size_t round_number, c
     {
         ROTxnManaged ro_txn(env);
         MapConfig table_config{"bench_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
-        auto cursor = ro_txn.ro_cursor(table_config);
+        FastCursor<> cursor{ro_txn, table_config};
         
         for (size_t index : ctx.test_indices) {
             std::string key = generate_key(index);
             
             double latency_us = measure_operation_us([&]() {
-                auto find_result = cursor->find(str_to_slice(key), false);
+                auto find_result = cursor.find(str_to_slice(key), false);
                 if (find_result.done) {
                     std::string value = std::string(find_result.value.as_string());
                     read_data.emplace_back(std::move(key), std::move(value));
@@ -234,7 +273,7 @@ RoundResult perform_update_test(::mdbx::env_managed& env, size_t round_number, c
     {
         RWTxnManaged rw_txn(env);
         MapConfig table_config{"bench_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
-        auto cursor = rw_txn.rw_cursor(table_config);
+        FastCursor<> cursor{rw_txn, table_config};
         
         auto write_start = std::chrono::high_resolution_clock::now();
         
@@ -243,7 +282,7 @@ RoundResult perform_update_test(::mdbx::env_managed& env, size_t round_number, c
             std::string new_value = generate_value(i + round_number * 1000000);
             
             double latency_us = measure_operation_us([&]() {
-                cursor->upsert(str_to_slice(key), str_to_slice(new_value));
+                cursor.upsert(str_to_slice(key), str_to_slice(new_value));
                 ctx.result.successful_writes++;
             });
             
@@ -313,7 +352,7 @@ RoundResult perform_mixed_test(::mdbx::env_managed& env, size_t round_number, co
         // Use read-write transaction for mixed operations
         RWTxnManaged rw_txn(env);
         MapConfig table_config{"bench_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
-        auto cursor = rw_txn.rw_cursor(table_config);
+        FastCursor<> cursor{rw_txn, table_config};
         
         // Perform mixed operations with 8:2 pattern
         size_t op_index = 0;
@@ -324,7 +363,7 @@ RoundResult perform_mixed_test(::mdbx::env_managed& env, size_t round_number, co
                 std::string key = generate_key(index);
                 
                 double latency_us = measure_operation_us([&]() {
-                    auto find_result = cursor->find(str_to_slice(key), false);
+                    auto find_result = cursor.find(str_to_slice(key), false);
                     if (find_result.done) {
                         ctx.result.successful_reads++;
                     }
@@ -341,7 +380,7 @@ RoundResult perform_mixed_test(::mdbx::env_managed& env, size_t round_number, co
                 std::string new_value = generate_value(index + round_number * 1000000);
                 
                 double latency_us = measure_operation_us([&]() {
-                    cursor->upsert(str_to_slice(key), str_to_slice(new_value));
+                    cursor.upsert(str_to_slice(key), str_to_slice(new_value));
                     ctx.result.successful_writes++;
                 });
                 
@@ -358,7 +397,7 @@ RoundResult perform_mixed_test(::mdbx::env_managed& env, size_t round_number, co
             if (op_index % batch_size < 8) {
                 // Read operation
                 double latency_us = measure_operation_us([&]() {
-                    auto find_result = cursor->find(str_to_slice(key), false);
+                    auto find_result = cursor.find(str_to_slice(key), false);
                     if (find_result.done) {
                         ctx.result.successful_reads++;
                     }
@@ -369,7 +408,7 @@ RoundResult perform_mixed_test(::mdbx::env_managed& env, size_t round_number, co
                 std::string new_value = generate_value(index + round_number * 1000000);
                 
                 double latency_us = measure_operation_us([&]() {
-                    cursor->upsert(str_to_slice(key), str_to_slice(new_value));
+                    cursor.upsert(str_to_slice(key), str_to_slice(new_value));
                     ctx.result.successful_writes++;
                 });
                 ctx.result.write_latencies_us.push_back(latency_us);
@@ -424,42 +463,71 @@ std::vector<RoundResult> run_comprehensive_benchmark(::mdbx::env_managed& env, c
     std::vector<RoundResult> results;
     results.reserve(config.test_rounds * 4); // 4 test modes
     
+    // Hardware counters of the process, reset for each round
+    std::optional<PerfCounters> perf;
+    if (config.perf_counters) {
+        perf.emplace();
+        if (!perf->available()) {
+            fmt::println("⚠ perf_event_open unavailable (check kernel.perf_event_paranoid), perf counters disabled");
+            perf.reset();
+        }
+    }
+    
+    // Engine statistics are captured at both ends of each round, page operations are reported for the round
+    auto run_round = [&](auto perform_test, size_t round) {
+        const auto start = capture_engine_stats(env);
+        if (perf) {
+            perf->start();
+        }
+        auto result = perform_test(env, round, config);
+        if (perf) {
+            result.perf = perf->stop();
+            fmt::println("✓ Perf: {}", format_perf_counts(result.perf, result.test_kv_count));
+        }
+        result.engine = capture_engine_stats(env);
+        diff_page_ops(result.engine, start);
+        fmt::print("✓");
+        print_engine_stats(result.engine);
+        results.push_back(std::move(result));
+    };
+    
     // Test Mode 1: Read-only tests
     fmt::println("\n--- READ-ONLY TESTS ---");
     for (size_t round = 1; round <= config.test_rounds; ++round) {
-        auto result = perform_read_test(env, round, config);
-        results.push_back(result);
+        run_round(perform_read_test, round);
     }
     
     // Test Mode 2: Write-only tests
     fmt::println("\n--- WRITE-ONLY TESTS ---");
     for (size_t round = 1; round <= config.test_rounds; ++round) {
-        auto result = perform_write_test(env, round, config);
-        results.push_back(result);
+        run_round(perform_write_test, round);
     }
     
     // Test Mode 3: Update tests
     fmt::println("\n--- UPDATE TESTS ---");
     for (size_t round = 1; round <= config.test_rounds; ++round) {
-        auto result = perform_update_test(env, round, config);
-        results.push_back(result);
+        run_round(perform_update_test, round);
     }
     
     // Test Mode 4: Mixed read-write tests
     fmt::println("\n--- MIXED READ-WRITE TESTS ---");
     for (size_t round = 1; round <= config.test_rounds; ++round) {
-        auto result = perform_mixed_test(env, round, config);
-        results.push_back(result);
+        run_round(perform_mixed_test, round);
     }
     
     return results;
 }
 
-void setup_environment(const std::string& db_path) {
+// Returns true when an existing database is reused as is (BenchConfig::reuse_db), which is then not populated
+bool setup_environment(const std::string& db_path, bool reuse_db) {
     fmt::println("\n=== Setting up Test Environment ===");
     
     // Check if database directory already exists
     if (std::filesystem::exists(db_path)) {
+        if (reuse_db) {
+            fmt::println("✓ Reusing existing database directory: {}", db_path);
+            return true;
+        }
         fmt::println(stderr, "❌ Error: Database directory already exists: {}", db_path);
         fmt::println(stderr, "");
         fmt::println(stderr, "Please manually remove or rename the existing database directory:");
@@ -468,8 +536,61 @@ void setup_environment(const std::string& db_path) {
         fmt::println(stderr, "  mv {} {}_backup_$(date +%%Y%%m%%d_%%H%%M%%S)", db_path, db_path);
         fmt::println(stderr, "");
         fmt::println(stderr, "This prevents accidental data loss during benchmark testing.");
+        fmt::println(stderr, "To run again on it, e.g. to warm up from its recorded heatmap, set MDBX_BENCH_REUSE_DB=1.");
         throw std::runtime_error("Database directory already exists");
     }
+    return false;
+}
+
+// Evict the clean pages of the (unmapped) data file from the page cache
+void drop_page_cache(const std::filesystem::path& data_file) {
+    const int fd = ::open(data_file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open " + data_file.string());
+    }
+    const int rc = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    if (rc != 0) {
+        throw std::runtime_error(fmt::format("posix_fadvise failed on {}: {}", data_file.string(), std::strerror(rc)));
+    }
+}
+
+// Reopen the environment cold and warm up the page cache before measuring, reporting progress until done.
+// The freshly populated database is still resident: it is closed and its pages evicted first, so that the rounds
+// start from the state the warmer is meant for
+void warm_up_environment(::mdbx::env_managed& env, const EnvConfig& env_config) {
+    if (!env_config.warmup) return;
+
+    env.close();
+    drop_page_cache(get_datafile_path(env_config.path));
+    env = open_env(env_config);
+    fmt::println("✓ Reopened MDBX environment with its pages evicted from the page cache");
+
+    MapConfig table_config{"bench_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+    auto warmer = start_page_warmer(env, env_config, {table_config});
+    if (!warmer) return;
+
+    fmt::println("\n=== Warming Up Page Cache ===");
+    fmt::println("Bandwidth limit: {} MiB/s, tree samples: {}, queue depth: {}",
+                 env_config.warmup_bandwidth / 1_Mebi, env_config.warmup_tree_samples, env_config.warmup_queue_depth);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    auto progress = warmer->progress();
+    while (progress.phase != WarmupPhase::kDone) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        progress = warmer->progress();
+        fmt::println("  Tree descents: {}, hot ranges: {}/{} bytes",
+                     progress.tree_descents, progress.hot_bytes_done, progress.hot_bytes_total);
+    }
+    warmer->wait();
+
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start_time);
+    if (progress.failed) {
+        fmt::println("⚠ Warm-up aborted after {} ms", duration.count());
+    } else {
+        fmt::println("✓ Warm-up completed in {} ms", duration.count());
+    }
 }
 
 int main(int argc, char* argv[]) {
@@ -522,14 +643,37 @@ int main(int argc, char* argv[]) {
     
     try {
         // Setup environment
-        setup_environment(bench_config.db_path);
+        const bool reused = setup_environment(bench_config.db_path, bench_config.reuse_db);
         
         // Open MDBX environment with Durable persistence
         auto env = open_env(env_config);
         fmt::println("✓ Opened MDBX environment at: {}", env_config.path);
         
-        // Populate database with initial data
-        populate_database(env, bench_config);
+        // Record the transaction metrics of RWTxnManaged if enabled
+        std::unique_ptr<MetricsEndpoint> metrics_endpoint;
+        if (bench_config.metrics_sample_rate > 0) {
+            enable_metrics(static_cast<uint32_t>(bench_config.metrics_sample_rate));
+            if (!bench_config.metrics_socket.empty()) {
+                metrics_endpoint = std::make_unique<MetricsEndpoint>(bench_config.metrics_socket);
+                fmt::println("✓ Serving metrics on: {}", bench_config.metrics_socket);
+            }
+        }
+        
+        // Populate database with initial data, unless reusing the one of a previous run
+        if (reused) {
+            fmt::println("✓ Skipping population, expecting {} KV pairs from the previous run", bench_config.total_kv_pairs);
+        } else {
+            populate_database(env, bench_config);
+        }
+        
+        // Cold start and warm up the page cache if enabled in EnvConfig, from the heatmap of a reused database
+        warm_up_environment(env, env_config);
+        
+        // Record the working set for the warm-up of the next run (started with reuse_db)
+        auto heatmap_recorder = start_heatmap_recorder(env_config);
+        if (heatmap_recorder) {
+            fmt::println("✓ Recording access heatmap to: {}", get_heatmap_path(env_config.path).string());
+        }
         
         // Run comprehensive benchmark suite
         auto results = run_comprehensive_benchmark(env, bench_config);
@@ -537,6 +681,16 @@ int main(int argc, char* argv[]) {
         // Print comprehensive summary
         print_comprehensive_summary(results, bench_config);
         
+        const auto& pool_stats = PooledCursor::handles_stats();
+        fmt::println("\nCursor handle pool: {} acquired, {:.2f}% reused ({} local, {} shared), {} dropped, "
+                     "{} closed on unbind failure",
+                     pool_stats.acquired, pool_stats.reuse_rate() * 100.0, pool_stats.local_hits,
+                     pool_stats.shared_hits, pool_stats.dropped, pool_stats.recycle_failures);
+        
+        if (metrics_enabled()) {
+            fmt::print("\n=== Metrics ===\n{}", MetricsRegistry::instance().dump());
+        }
+        
         fmt::println("\n✓ All benchmarks completed successfully! 🎉");
         
     } catch (const std::exception& e) {
@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <algorithm>
 #include <functional>
+#include <string_view>
 
 using namespace datastore::kvdb;
 using namespace utils;
@@ -38,6 +39,14 @@ EnvConfig create_default_env_config() {
     config.growth_size = 1_Gibi;
     config.max_tables = 64;
     config.max_readers = 50;
+    config.warmup = false;
+    config.warmup_bandwidth = 256_Mebi;
+    config.warmup_tree_samples = 64_Kibi;
+    config.warmup_queue_depth = 32;
+    config.heatmap = false;
+    config.heatmap_sample_rate = 128;
+    config.heatmap_flush_interval = 60;
+    config.heatmap_extent_size = 256_Kibi;
     return config;
 }
 
@@ -65,6 +74,14 @@ void load_env_config_from_json(const Json::Value& root, EnvConfig& config) {
     if (root.isMember("growth_size")) config.growth_size = root["growth_size"].asUInt64();
     if (root.isMember("max_tables")) config.max_tables = root["max_tables"].asUInt();
     if (root.isMember("max_readers")) config.max_readers = root["max_readers"].asUInt();
+    if (root.isMember("warmup")) config.warmup = root["warmup"].asBool();
+    if (root.isMember("warmup_bandwidth")) config.warmup_bandwidth = root["warmup_bandwidth"].asUInt64();
+    if (root.isMember("warmup_tree_samples")) config.warmup_tree_samples = root["warmup_tree_samples"].asUInt64();
+    if (root.isMember("warmup_queue_depth")) config.warmup_queue_depth = root["warmup_queue_depth"].asUInt();
+    if (root.isMember("heatmap")) config.heatmap = root["heatmap"].asBool();
+    if (root.isMember("heatmap_sample_rate")) config.heatmap_sample_rate = root["heatmap_sample_rate"].asUInt();
+    if (root.isMember("heatmap_flush_interval")) config.heatmap_flush_interval = root["heatmap_flush_interval"].asUInt();
+    if (root.isMember("heatmap_extent_size")) config.heatmap_extent_size = root["heatmap_extent_size"].asUInt64();
 }
 
 // EnvConfig loader with JSON support
@@ -84,7 +101,13 @@ BenchConfig create_default_bench_config() {
     config.test_kv_pairs = 100000;
     config.test_rounds = 2;
     config.batch_size = 5000000;
+    config.read_prefetch_threads = 0;
+    config.read_prefetch_distance = 64;
+    config.metrics_sample_rate = 0;
+    config.metrics_socket = "";
+    config.perf_counters = false;
     config.db_path = "/data/mdbx_bench";
+    config.reuse_db = false;
     return config;
 }
 
@@ -104,12 +127,24 @@ void load_env_var_string(const char* env_name, std::string& value) {
     }
 }
 
+void load_env_var_bool(const char* env_name, bool& value) {
+    if (const char* env_val = std::getenv(env_name)) {
+        value = std::string_view(env_val) == "1" || std::string_view(env_val) == "true";
+    }
+}
+
 void load_bench_config_from_env(BenchConfig& config) {
     load_env_var_size_t("MDBX_BENCH_TOTAL_KV_PAIRS", config.total_kv_pairs);
     load_env_var_size_t("MDBX_BENCH_TEST_KV_PAIRS", config.test_kv_pairs);
     load_env_var_size_t("MDBX_BENCH_TEST_ROUNDS", config.test_rounds);
     load_env_var_size_t("MDBX_BENCH_BATCH_SIZE", config.batch_size);
+    load_env_var_size_t("MDBX_BENCH_READ_PREFETCH_THREADS", config.read_prefetch_threads);
+    load_env_var_size_t("MDBX_BENCH_READ_PREFETCH_DISTANCE", config.read_prefetch_distance);
+    load_env_var_size_t("MDBX_BENCH_METRICS_SAMPLE_RATE", config.metrics_sample_rate);
+    load_env_var_string("MDBX_BENCH_METRICS_SOCKET", config.metrics_socket);
+    load_env_var_bool("MDBX_BENCH_PERF_COUNTERS", config.perf_counters);
     load_env_var_string("MDBX_BENCH_DB_PATH", config.db_path);
+    load_env_var_bool("MDBX_BENCH_REUSE_DB", config.reuse_db);
 }
 
 void load_bench_config_from_json(const Json::Value& root, BenchConfig& config) {
@@ -117,7 +152,13 @@ void load_bench_config_from_json(const Json::Value& root, BenchConfig& config) {
     if (root.isMember("test_kv_pairs")) config.test_kv_pairs = root["test_kv_pairs"].asUInt64();
     if (root.isMember("test_rounds")) config.test_rounds = root["test_rounds"].asUInt64();
     if (root.isMember("batch_size")) config.batch_size = root["batch_size"].asUInt64();
+    if (root.isMember("read_prefetch_threads")) config.read_prefetch_threads = root["read_prefetch_threads"].asUInt64();
+    if (root.isMember("read_prefetch_distance")) config.read_prefetch_distance = root["read_prefetch_distance"].asUInt64();
+    if (root.isMember("metrics_sample_rate")) config.metrics_sample_rate = root["metrics_sample_rate"].asUInt64();
+    if (root.isMember("metrics_socket")) config.metrics_socket = root["metrics_socket"].asString();
+    if (root.isMember("perf_counters")) config.perf_counters = root["perf_counters"].asBool();
     if (root.isMember("db_path")) config.db_path = root["db_path"].asString();
+    if (root.isMember("reuse_db")) config.reuse_db = root["reuse_db"].asBool();
     
     if (root.isMember("key_size") || root.isMember("value_size")) {
         fmt::println("⚠ key_size and value_size are fixed at 32 bytes, ignoring config file values");
@@ -234,6 +275,55 @@ TestContext init_test_context(size_t round_number, const BenchConfig& config, co
     return ctx;
 }
 
+// Snapshot of the engine internals, from mdbx_env_info_ex and the map stats of a read transaction
+MdbxEngineStats capture_engine_stats(::mdbx::env_managed& env) {
+    MdbxEngineStats stats;
+    const auto info = env.get_info();
+    stats.page_size = info.mi_dxb_pagesize;
+    stats.used_bytes = (info.mi_last_pgno + 1) * info.mi_dxb_pagesize;
+    stats.geo_current = info.mi_geo.current;
+    stats.geo_upper = info.mi_geo.upper;
+    stats.map_size = info.mi_mapsize;
+    stats.readers = info.mi_numreaders;
+    stats.reader_lag = info.mi_recent_txnid - info.mi_latter_reader_txnid;
+    stats.pages_dirtied = info.mi_pgop_stat.newly + info.mi_pgop_stat.cow + info.mi_pgop_stat.clone;
+    stats.pages_spilled = info.mi_pgop_stat.spill;
+    
+    ROTxnManaged ro_txn(env);
+    MapConfig table_config{"bench_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+    if (has_map(*ro_txn, table_config.name)) {
+        PooledCursor cursor(ro_txn, table_config);
+        const MDBX_stat table_stat = cursor.get_map_stat();
+        stats.tree_depth = table_stat.ms_depth;
+        stats.branch_pages = table_stat.ms_branch_pages;
+        stats.leaf_pages = table_stat.ms_leaf_pages;
+        stats.overflow_pages = table_stat.ms_overflow_pages;
+        stats.entries = table_stat.ms_entries;
+    }
+    // The GC is the map with handle 0 (FREE_DBI)
+    const auto gc_stat = ro_txn->get_map_stat(::mdbx::map_handle{0});
+    stats.gc_records = gc_stat.ms_entries;
+    stats.gc_pages = gc_stat.ms_branch_pages + gc_stat.ms_leaf_pages + gc_stat.ms_overflow_pages;
+    ro_txn.abort();
+    
+    stats.captured = true;
+    return stats;
+}
+
+void diff_page_ops(MdbxEngineStats& end, const MdbxEngineStats& start) {
+    end.pages_dirtied -= start.pages_dirtied;
+    end.pages_spilled -= start.pages_spilled;
+}
+
+void print_engine_stats(const MdbxEngineStats& stats) {
+    fmt::println("  Engine: Depth={}, Pages(branch/leaf/overflow)={}/{}/{}, GC={} records/{} pages, "
+                 "Dirtied={}, Spilled={}, Readers={}, ReaderLag={}, Used={:.1f}MB/{:.1f}MB (upper {:.1f}MB)",
+                 stats.tree_depth, stats.branch_pages, stats.leaf_pages, stats.overflow_pages,
+                 stats.gc_records, stats.gc_pages, stats.pages_dirtied, stats.pages_spilled, stats.readers,
+                 stats.reader_lag, stats.used_bytes / 1048576.0, stats.geo_current / 1048576.0,
+                 stats.geo_upper / 1048576.0);
+}
+
 // Summary and output functions
 
 void print_comprehensive_summary(const std::vector<RoundResult>& results, const BenchConfig& config) {
@@ -271,10 +361,19 @@ void print_comprehensive_summary(const std::vector<RoundResult>& results, const
         double total_avg_latency = 0.0, total_tp99_latency = 0.0;
         double total_time = 0.0, total_commit_time = 0.0;
         size_t total_operations = 0;
+        size_t latency_rounds = 0;
         
         fmt::println("Per-Round Results:");
         for (const auto& result : mode_results) {
-            if (mode_name == "READ-ONLY") {
+            if (!result.throughput_only) {
+                latency_rounds++;
+            }
+            if (mode_name == "READ-ONLY" && result.throughput_only) {
+                fmt::println("  Round {}: Time={:.2f}ms, Success={}, batched (throughput only)",
+                           result.round_number, result.read_time_ms, result.successful_reads);
+                total_time += result.read_time_ms;
+                total_operations += result.successful_reads;
+            } else if (mode_name == "READ-ONLY") {
                 fmt::println("  Round {}: Time={:.2f}ms, Success={}, Avg={:.1f}μs, Tp99={:.1f}μs",
                            result.round_number, result.read_time_ms, result.successful_reads,
                            result.avg_read_latency_us, result.tp99_read_latency_us);
@@ -312,17 +411,24 @@ void print_comprehensive_summary(const std::vector<RoundResult>& results, const
                 total_commit_time += result.commit_time_ms;
                 total_operations += result.successful_mixed;
             }
+            if (result.engine.captured) {
+                fmt::print("  ");
+                print_engine_stats(result.engine);
+            }
+            if (result.perf.captured()) {
+                fmt::println("    Perf: {}", utils::format_perf_counts(result.perf, result.test_kv_count));
+            }
         }
         
-        double avg_avg_latency = total_avg_latency / mode_results.size();
-        double avg_tp99_latency = total_tp99_latency / mode_results.size();
         double avg_time = total_time / mode_results.size();
         double avg_commit_time = total_commit_time / mode_results.size();
         double avg_throughput = (static_cast<double>(total_operations) / mode_results.size()) / (avg_time / 1000.0);
         
         fmt::println("Summary Statistics:");
-        fmt::println("  Average Latency: {:.1f} μs", avg_avg_latency);
-        fmt::println("  Tp99 Latency: {:.1f} μs", avg_tp99_latency);
+        if (latency_rounds > 0) {
+            fmt::println("  Average Latency: {:.1f} μs", total_avg_latency / latency_rounds);
+            fmt::println("  Tp99 Latency: {:.1f} μs", total_tp99_latency / latency_rounds);
+        }
         fmt::println("  Average Time: {:.2f} ms", avg_time);
         if (avg_commit_time > 0) {
             fmt::println("  Average Commit Time: {:.2f} ms", avg_commit_time);
@@ -348,7 +454,15 @@ void print_usage(const char* program_name) {
     fmt::println("  MDBX_BENCH_TEST_KV_PAIRS   KV pairs to test per round");
     fmt::println("  MDBX_BENCH_TEST_ROUNDS     Number of test rounds");
     fmt::println("  MDBX_BENCH_BATCH_SIZE      Batch size for database population");
+    fmt::println("  MDBX_BENCH_READ_PREFETCH_THREADS   Helper readers for batched reads (0 = serial reads)");
+    fmt::println("  MDBX_BENCH_READ_PREFETCH_DISTANCE  Max keys prefetched ahead in batched reads");
+    fmt::println("  MDBX_BENCH_METRICS_SAMPLE_RATE     Time one operation out of N per thread (0 = metrics off)");
+    fmt::println("  MDBX_BENCH_METRICS_SOCKET          Unix socket serving the metrics during the run");
+    fmt::println("  MDBX_BENCH_PERF_COUNTERS           1 to count cycles, cache/TLB misses and page faults per round");
     fmt::println("  MDBX_BENCH_DB_PATH         Database path");
+    fmt::println("  MDBX_BENCH_REUSE_DB        1 to reopen an existing database without populating it; its recorded");
+    fmt::println("                             heatmap (mdbx.heat) then drives the warm-up. Otherwise the database");
+    fmt::println("                             directory must not exist, and the heatmap is only recorded for a later run");
     fmt::println("  Note: Key and value sizes are fixed at 32 bytes");
     fmt::println("");
     fmt::println("Example EnvConfig JSON file:");
@@ -6,6 +6,7 @@
 #include <functional>
 #include <json/json.h>
 #include "db/mdbx.hpp"
+#include "utils/perf_counters.hpp"
 
 // Configuration structures for benchmark parameters
 struct BenchConfig {
@@ -21,8 +22,54 @@ struct BenchConfig {
     // Batch processing parameters
     size_t batch_size = 5000000;        // Batch size for database population (5M default)
     
+    // Batched read parameters (read_prefetch_threads = 0 keeps the serial cursor->find loop)
+    size_t read_prefetch_threads = 0;   // Helper readers prefetching pages ahead in read tests
+    size_t read_prefetch_distance = 64; // Max keys the prefetchers may run ahead
+    
+    // Metrics registry (utils/metrics.hpp), dumped after the summary
+    size_t metrics_sample_rate = 0;     // Time one operation out of this many per thread, 0 disables metrics
+    std::string metrics_socket;         // Unix socket serving the metrics during the run, empty for none
+    
+    // Hardware counters (perf_event_open) of each round: cycles, instructions, LLC/dTLB misses, page faults
+    bool perf_counters = false;
+    
     // Database path
     std::string db_path = "/data/mdbx_bench";
+    
+    // Reopen an existing db_path as is instead of refusing it: no population, the warm-up loads the heatmap
+    // (mdbx.heat) recorded by the previous run. The database must have been populated with the same total_kv_pairs
+    bool reuse_db = false;
+};
+
+// MDBX engine internals captured at a round boundary, to correlate latency with tree growth
+struct MdbxEngineStats {
+    bool captured = false;
+    
+    // bench_table B-tree
+    uint32_t tree_depth = 0;
+    uint64_t branch_pages = 0;
+    uint64_t leaf_pages = 0;
+    uint64_t overflow_pages = 0;
+    uint64_t entries = 0;
+    
+    // GC B-tree, holding the freelist of pages retired by past transactions
+    uint64_t gc_records = 0;
+    uint64_t gc_pages = 0;
+    
+    // Page operations, cumulative since the environment was opened (per round once diffed with diff_page_ops)
+    uint64_t pages_dirtied = 0;  // Pages allocated or copied-on-write by write transactions
+    uint64_t pages_spilled = 0;  // Dirty pages spilled to disk before commit (dirty page limit reached)
+    
+    // Readers
+    uint32_t readers = 0;
+    uint64_t reader_lag = 0;     // Transactions between the latest one and the oldest reader, which pins the GC
+    
+    // mmap geometry
+    uint32_t page_size = 0;
+    uint64_t used_bytes = 0;     // Up to the last allocated page
+    uint64_t geo_current = 0;    // Current datafile size
+    uint64_t geo_upper = 0;      // Upper size limit
+    uint64_t map_size = 0;       // Size of the memory mapping
 };
 
 // Structure to hold timing results for each round
@@ -48,6 +95,10 @@ struct RoundResult {
     double tp99_write_latency_us = 0.0;
     double avg_mixed_latency_us = 0.0;
     double tp99_mixed_latency_us = 0.0;
+    bool throughput_only = false;            // Batched reads: no per-operation latency, only the round time
+    
+    MdbxEngineStats engine;
+    utils::PerfCounts perf;
 };
 
 // Forward declaration to avoid circular dependency
@@ -97,6 +148,11 @@ double measure_operation_us(Func&& operation) {
     return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
 }
 
+// Engine statistics functions
+MdbxEngineStats capture_engine_stats(::mdbx::env_managed& env);
+void diff_page_ops(MdbxEngineStats& end, const MdbxEngineStats& start);
+void print_engine_stats(const MdbxEngineStats& stats);
+
 // Summary and output functions
 void print_comprehensive_summary(const std::vector<RoundResult>& results, const BenchConfig& config);
 void print_usage(const char* program_name);
@@ -12,9 +12,22 @@
 #include <cstdlib>
 #include <memory>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <optional>
+#include <thread>
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/sst_file_writer.h>
+#include <rocksdb/statistics.h>
+
+#include "db/rocksdb_config.hpp"
+#include "utils/perf_counters.hpp"
 
 
 // Configuration structure for benchmark parameters
@@ -28,68 +41,29 @@ struct BenchConfig {
     // Test parameters
     size_t test_rounds = 2;             // Number of test rounds to run
     
+    // Load parameters
+    std::string load_mode = "memtable"; // "memtable" (WriteBatch + compaction) or "ingest" (SstFileWriter + IngestExternalFile)
+    size_t ingest_threads = 0;          // Threads building SST files in ingest mode, 0 = hardware concurrency
+    size_t ingest_file_keys = 4000000;  // KV pairs per ingested SST file (~256MB)
+    
+    // Engine telemetry: rocksdb.* properties and statistics sampled during each round. Enables CreateDBStatistics(),
+    // whose tickers cost a few percent of throughput, so it is off unless asked for
+    bool telemetry = false;
+    size_t telemetry_interval_ms = 100;  // Sampling period of the properties
+    bool wait_for_compaction = false;    // Flush and wait for compactions to finish before the read rounds
+    size_t compaction_wait_timeout_s = 600;  // Start the read rounds anyway after that, 0 waits forever
+    
+    // Hardware counters (perf_event_open) of each round: cycles, instructions, LLC/dTLB misses, page faults
+    bool perf_counters = false;
+    
+    // Batched read parameters (read_batch_size = 0 keeps the serial db.get loop)
+    size_t read_batch_size = 0;         // Keys per DB::MultiGet call in read tests
+    bool read_async_io = true;          // Let MultiGet read the SST blocks of a batch in parallel
+    
     // Database path
     std::string db_path = "/data/rocksdb_bench";
 };
 
-// RocksDBConfig loader with JSON support
-struct RocksDBConfig {
-    std::string path = "/data/rocksdb_bench";
-    bool create_if_missing = true;
-    int max_open_files = 300;
-    size_t write_buffer_size = 64 << 20;    // 64MB
-    int max_write_buffer_number = 3;
-    size_t target_file_size_base = 64 << 20;  // 64MB
-    size_t max_bytes_for_level_base = 256 << 20;  // 256MB
-    int level0_file_num_compaction_trigger = 4;
-    int level0_slowdown_writes_trigger = 20;
-    int level0_stop_writes_trigger = 36;
-};
-
-RocksDBConfig load_rocksdb_config(const std::string& config_file) {
-    RocksDBConfig config;
-    
-    // Set defaults
-    config.path = "/data/rocksdb_bench";
-    config.create_if_missing = true;
-    config.max_open_files = 300;
-    config.write_buffer_size = 64 << 20;
-    config.max_write_buffer_number = 3;
-    config.target_file_size_base = 64 << 20;
-    config.max_bytes_for_level_base = 256 << 20;
-    config.level0_file_num_compaction_trigger = 4;
-    config.level0_slowdown_writes_trigger = 20;
-    config.level0_stop_writes_trigger = 36;
-    
-    // Try to load from file if it exists
-    if (!config_file.empty() && std::filesystem::exists(config_file)) {
-        try {
-            std::ifstream file(config_file);
-            Json::Value root;
-            file >> root;
-            
-            if (root.isMember("path")) config.path = root["path"].asString();
-            if (root.isMember("create_if_missing")) config.create_if_missing = root["create_if_missing"].asBool();
-            if (root.isMember("max_open_files")) config.max_open_files = root["max_open_files"].asInt();
-            if (root.isMember("write_buffer_size")) config.write_buffer_size = root["write_buffer_size"].asUInt64();
-            if (root.isMember("max_write_buffer_number")) config.max_write_buffer_number = root["max_write_buffer_number"].asInt();
-            if (root.isMember("target_file_size_base")) config.target_file_size_base = root["target_file_size_base"].asUInt64();
-            if (root.isMember("max_bytes_for_level_base")) config.max_bytes_for_level_base = root["max_bytes_for_level_base"].asUInt64();
-            if (root.isMember("level0_file_num_compaction_trigger")) config.level0_file_num_compaction_trigger = root["level0_file_num_compaction_trigger"].asInt();
-            if (root.isMember("level0_slowdown_writes_trigger")) config.level0_slowdown_writes_trigger = root["level0_slowdown_writes_trigger"].asInt();
-            if (root.isMember("level0_stop_writes_trigger")) config.level0_stop_writes_trigger = root["level0_stop_writes_trigger"].asInt();
-            
-            fmt::println("✓ Loaded RocksDBConfig from: {}", config_file);
-        } catch (const std::exception& e) {
-            fmt::println("⚠ Failed to load config file {}, using defaults: {}", config_file, e.what());
-        }
-    } else {
-        fmt::println("✓ Using default RocksDBConfig (file not found: {})", config_file);
-    }
-    
-    return config;
-}
-
 // BenchConfig loader with JSON and environment variable support
 BenchConfig load_bench_config(const std::string& config_file) {
     BenchConfig config;
@@ -125,6 +99,26 @@ BenchConfig load_bench_config(const std::string& config_file) {
         }
     }
     
+    if (const char* env_val = std::getenv("ROCKSDB_BENCH_WAIT_FOR_COMPACTION")) {
+        config.wait_for_compaction = std::string_view(env_val) == "1" || std::string_view(env_val) == "true";
+    }
+    
+    if (const char* env_val = std::getenv("ROCKSDB_BENCH_PERF_COUNTERS")) {
+        config.perf_counters = std::string_view(env_val) == "1" || std::string_view(env_val) == "true";
+    }
+    
+    if (const char* env_val = std::getenv("ROCKSDB_BENCH_LOAD_MODE")) {
+        config.load_mode = env_val;
+    }
+    
+    if (const char* env_val = std::getenv("ROCKSDB_BENCH_READ_BATCH_SIZE")) {
+        try {
+            config.read_batch_size = std::stoull(env_val);
+        } catch (const std::exception& e) {
+            fmt::println("⚠ Invalid ROCKSDB_BENCH_READ_BATCH_SIZE: {}", env_val);
+        }
+    }
+    
     if (const char* env_val = std::getenv("ROCKSDB_BENCH_DB_PATH")) {
         config.db_path = env_val;
     }
@@ -140,6 +134,16 @@ BenchConfig load_bench_config(const std::string& config_file) {
             if (root.isMember("test_kv_pairs")) config.test_kv_pairs = root["test_kv_pairs"].asUInt64();
             if (root.isMember("test_rounds")) config.test_rounds = root["test_rounds"].asUInt64();
             if (root.isMember("db_path")) config.db_path = root["db_path"].asString();
+            if (root.isMember("load_mode")) config.load_mode = root["load_mode"].asString();
+            if (root.isMember("ingest_threads")) config.ingest_threads = root["ingest_threads"].asUInt64();
+            if (root.isMember("ingest_file_keys")) config.ingest_file_keys = root["ingest_file_keys"].asUInt64();
+            if (root.isMember("telemetry")) config.telemetry = root["telemetry"].asBool();
+            if (root.isMember("telemetry_interval_ms")) config.telemetry_interval_ms = root["telemetry_interval_ms"].asUInt64();
+            if (root.isMember("wait_for_compaction")) config.wait_for_compaction = root["wait_for_compaction"].asBool();
+            if (root.isMember("compaction_wait_timeout_s")) config.compaction_wait_timeout_s = root["compaction_wait_timeout_s"].asUInt64();
+            if (root.isMember("perf_counters")) config.perf_counters = root["perf_counters"].asBool();
+            if (root.isMember("read_batch_size")) config.read_batch_size = root["read_batch_size"].asUInt64();
+            if (root.isMember("read_async_io")) config.read_async_io = root["read_async_io"].asBool();
             
             // Ignore key_size and value_size from config file since they are fixed
             if (root.isMember("key_size") || root.isMember("value_size")) {
@@ -182,17 +186,13 @@ private:
     rocksdb::Options options_;
     
 public:
-    RocksDBBench(const RocksDBConfig& config) {
-        // Configure RocksDB options
-        options_.create_if_missing = config.create_if_missing;
-        options_.max_open_files = config.max_open_files;
-        options_.write_buffer_size = config.write_buffer_size;
-        options_.max_write_buffer_number = config.max_write_buffer_number;
-        options_.target_file_size_base = config.target_file_size_base;
-        options_.max_bytes_for_level_base = config.max_bytes_for_level_base;
-        options_.level0_file_num_compaction_trigger = config.level0_file_num_compaction_trigger;
-        options_.level0_slowdown_writes_trigger = config.level0_slowdown_writes_trigger;
-        options_.level0_stop_writes_trigger = config.level0_stop_writes_trigger;
+    RocksDBBench(const RocksDBConfig& config, bool statistics = false) {
+        // Configure RocksDB options, the same way RocksDbImpl does
+        apply_rocksdb_config(config, options_);
+        if (statistics) {
+            // Tickers for block cache hits, write stalls and flush/compaction bytes
+            options_.statistics = rocksdb::CreateDBStatistics();
+        }
         
         // Open database
         rocksdb::DB* raw_db = nullptr;
@@ -217,11 +217,44 @@ public:
         return status.ok();
     }
     
+    // Looks up sorted keys with one DB::MultiGet call, returns the number found
+    size_t multi_get(std::span<const rocksdb::Slice> sorted_keys, bool async_io) {
+        rocksdb::ReadOptions read_options;
+        // With async_io the SST block reads of the batch are issued in parallel (io_uring when available)
+        read_options.async_io = async_io;
+        read_options.optimize_multiget_for_io = async_io;
+        
+        std::vector<rocksdb::PinnableSlice> values(sorted_keys.size());
+        std::vector<rocksdb::Status> statuses(sorted_keys.size());
+        db_->MultiGet(read_options, db_->DefaultColumnFamily(), sorted_keys.size(), sorted_keys.data(),
+                      values.data(), statuses.data(), /*sorted_input=*/true);
+        
+        size_t found = 0;
+        for (const auto& status : statuses) {
+            if (status.ok()) {
+                found++;
+            } else if (!status.IsNotFound()) {
+                throw std::runtime_error(fmt::format("RocksDB MultiGet failed: {}", status.ToString()));
+            }
+        }
+        return found;
+    }
+    
     rocksdb::DB* get_db() { return db_.get(); }
+    const rocksdb::Options& options() const { return options_; }
+    
+    uint64_t int_property(const std::string& name) {
+        uint64_t value = 0;
+        return db_->GetIntProperty(name, &value) ? value : 0;
+    }
+    
+    uint64_t ticker(rocksdb::Tickers ticker) const {
+        return options_.statistics ? options_.statistics->getTickerCount(ticker) : 0;
+    }
 };
 
-// Populate RocksDB database with initial dataset
-void populate_database(RocksDBBench& db, const BenchConfig& config) {
+// Populate RocksDB database with initial dataset, returns the load time in milliseconds
+double populate_database(RocksDBBench& db, const BenchConfig& config) {
     fmt::println("\n=== Populating Database ===");
     fmt::println("Inserting {} KV pairs into database", config.total_kv_pairs);
     
@@ -280,6 +313,90 @@ void populate_database(RocksDBBench& db, const BenchConfig& config) {
                  config.total_kv_pairs, total_duration);
     fmt::println("  Key size: {} bytes", BenchConfig::key_size);
     fmt::println("  Value size: {} bytes", BenchConfig::value_size);
+    
+    return std::chrono::duration<double, std::milli>(end_time - start_time).count();
+}
+
+// Bulk load: sorted SST files are built in parallel with SstFileWriter, then imported with IngestExternalFile.
+// generate_key() is ordered like the indices, so each file holds a contiguous index range and the files do not
+// overlap: they are ingested straight into the bottom level, skipping the memtable, WAL and compactions.
+// Returns the load time in milliseconds
+double ingest_database(RocksDBBench& db, const BenchConfig& config) {
+    fmt::println("\n=== Populating Database (SST ingestion) ===");
+    
+    const size_t file_keys = std::max<size_t>(config.ingest_file_keys, 1);
+    const size_t file_count = (config.total_kv_pairs + file_keys - 1) / file_keys;
+    const size_t thread_count = std::min(
+        config.ingest_threads > 0 ? config.ingest_threads : std::max<size_t>(std::thread::hardware_concurrency(), 1),
+        std::max<size_t>(file_count, 1));
+    fmt::println("Writing {} KV pairs into {} SST files with {} threads", config.total_kv_pairs, file_count, thread_count);
+    
+    // Next to the database so that ingestion moves the files instead of copying them
+    const std::filesystem::path staging_dir = config.db_path + "_ingest";
+    std::filesystem::remove_all(staging_dir);
+    std::filesystem::create_directories(staging_dir);
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::vector<std::string> files(file_count);
+    std::atomic<size_t> next_file{0};
+    std::vector<std::exception_ptr> errors(thread_count);
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&, t]() {
+            try {
+                for (size_t file = next_file++; file < file_count; file = next_file++) {
+                    files[file] = (staging_dir / fmt::format("bulk_{:06}.sst", file)).string();
+                    // Same options as the column family, so the files need no rewrite on ingestion
+                    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), db.options());
+                    rocksdb::Status status = writer.Open(files[file]);
+                    const size_t end = std::min(config.total_kv_pairs, (file + 1) * file_keys);
+                    for (size_t i = file * file_keys; status.ok() && i < end; ++i) {
+                        status = writer.Put(generate_key(i), generate_value(i));
+                    }
+                    if (status.ok()) {
+                        status = writer.Finish();
+                    }
+                    if (!status.ok()) {
+                        throw std::runtime_error(fmt::format("SST file {} write failed: {}", files[file], status.ToString()));
+                    }
+                }
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    
+    auto build_end = std::chrono::high_resolution_clock::now();
+    fmt::println("✓ Built {} SST files in {} ms", file_count,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(build_end - start_time).count());
+    
+    if (!files.empty()) {
+        rocksdb::IngestExternalFileOptions ingest_options;
+        ingest_options.move_files = true;
+        rocksdb::Status status = db.get_db()->IngestExternalFile(files, ingest_options);
+        if (!status.ok()) {
+            throw std::runtime_error(fmt::format("RocksDB IngestExternalFile failed: {}", status.ToString()));
+        }
+    }
+    std::filesystem::remove_all(staging_dir);
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    fmt::println("✓ Ingested {} SST files in {} ms", file_count,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(end_time - build_end).count());
+    fmt::println("✓ Database populated with {} KV pairs in {} seconds", config.total_kv_pairs,
+                 std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time).count());
+    
+    return std::chrono::duration<double, std::milli>(end_time - start_time).count();
 }
 
 // Generate random indices for testing
@@ -301,6 +418,123 @@ std::vector<size_t> generate_random_indices(size_t count, size_t max_index) {
     return indices;
 }
 
+// RocksDB internals over one round: the write numbers alone hide the compaction debt a round leaves behind
+struct EngineTelemetry {
+    bool sampled = false;
+    uint64_t max_pending_compaction_bytes = 0;  // Peak rocksdb.estimate-pending-compaction-bytes
+    uint64_t max_l0_files = 0;                  // Peak rocksdb.num-files-at-level0
+    uint64_t max_running_compactions = 0;       // Peak rocksdb.num-running-compactions
+    bool write_stopped = false;                 // rocksdb.is-write-stopped seen set
+    uint64_t stall_micros = 0;                  // Time writers spent stalled during the round
+    double block_cache_hit_rate = 0.0;          // Block cache hits / lookups during the round
+    double write_amplification = 0.0;           // Flush + compaction bytes written / user bytes written, since open
+};
+
+// Samples rocksdb.* properties in a background thread while a round runs, and diffs statistics tickers around it
+class RocksDBTelemetry {
+public:
+    RocksDBTelemetry(RocksDBBench& db, std::chrono::milliseconds interval) : db_(db), interval_(interval) {}
+    
+    ~RocksDBTelemetry() { stop_sampler(); }
+    
+    void begin_round() {
+        current_ = EngineTelemetry{};
+        current_.sampled = true;
+        stall_micros_ = db_.ticker(rocksdb::STALL_MICROS);
+        cache_hits_ = db_.ticker(rocksdb::BLOCK_CACHE_HIT);
+        cache_misses_ = db_.ticker(rocksdb::BLOCK_CACHE_MISS);
+        sample();
+        sampler_ = std::jthread([this](std::stop_token stop) {
+            std::mutex mutex;
+            std::condition_variable_any cv;
+            std::unique_lock lock(mutex);
+            while (true) {
+                cv.wait_for(lock, stop, interval_, [] { return false; });
+                if (stop.stop_requested()) break;
+                sample();
+            }
+        });
+    }
+    
+    EngineTelemetry end_round() {
+        stop_sampler();
+        sample();
+        current_.stall_micros = db_.ticker(rocksdb::STALL_MICROS) - stall_micros_;
+        const uint64_t hits = db_.ticker(rocksdb::BLOCK_CACHE_HIT) - cache_hits_;
+        const uint64_t misses = db_.ticker(rocksdb::BLOCK_CACHE_MISS) - cache_misses_;
+        current_.block_cache_hit_rate = hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+        current_.write_amplification = write_amplification();
+        return current_;
+    }
+    
+    double write_amplification() const {
+        const uint64_t user_bytes = db_.ticker(rocksdb::BYTES_WRITTEN);
+        const uint64_t engine_bytes = db_.ticker(rocksdb::FLUSH_WRITE_BYTES) + db_.ticker(rocksdb::COMPACT_WRITE_BYTES);
+        return user_bytes > 0 ? static_cast<double>(engine_bytes) / user_bytes : 0.0;
+    }
+    
+private:
+    void stop_sampler() {
+        if (sampler_.joinable()) {
+            sampler_.request_stop();
+            sampler_.join();
+        }
+    }
+    
+    // Only called by one thread at a time: the sampler, or the round thread once the sampler is stopped
+    void sample() {
+        current_.max_pending_compaction_bytes = std::max(current_.max_pending_compaction_bytes,
+            db_.int_property(rocksdb::DB::Properties::kEstimatePendingCompactionBytes));
+        current_.max_l0_files = std::max(current_.max_l0_files,
+            db_.int_property(rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0"));
+        current_.max_running_compactions = std::max(current_.max_running_compactions,
+            db_.int_property(rocksdb::DB::Properties::kNumRunningCompactions));
+        current_.write_stopped |= db_.int_property(rocksdb::DB::Properties::kIsWriteStopped) != 0;
+    }
+    
+    RocksDBBench& db_;
+    std::chrono::milliseconds interval_;
+    EngineTelemetry current_;
+    uint64_t stall_micros_ = 0;
+    uint64_t cache_hits_ = 0;
+    uint64_t cache_misses_ = 0;
+    std::jthread sampler_;
+};
+
+// Flushes the memtables and waits until no compaction is pending or running, so that read rounds do not
+// compete with the compaction debt of the load. The pending bytes are an estimate that may never drop to 0,
+// so the wait gives up after timeout (0 waits forever).
+void wait_for_compaction(RocksDBBench& db, std::chrono::seconds timeout) {
+    fmt::println("\n=== Waiting for Compaction Quiescence ===");
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    rocksdb::FlushOptions flush_options;
+    flush_options.wait = true;
+    rocksdb::Status status = db.get_db()->Flush(flush_options);
+    if (!status.ok()) {
+        throw std::runtime_error(fmt::format("RocksDB flush failed: {}", status.ToString()));
+    }
+    
+    while (db.int_property(rocksdb::DB::Properties::kCompactionPending) != 0 ||
+           db.int_property(rocksdb::DB::Properties::kNumRunningCompactions) != 0 ||
+           db.int_property(rocksdb::DB::Properties::kNumRunningFlushes) != 0 ||
+           db.int_property(rocksdb::DB::Properties::kEstimatePendingCompactionBytes) != 0) {
+        if (timeout.count() > 0 && std::chrono::high_resolution_clock::now() - start_time >= timeout) {
+            fmt::println("⚠ Compactions still pending after {} s ({} bytes estimated, {} running), starting the reads",
+                         timeout.count(),
+                         db.int_property(rocksdb::DB::Properties::kEstimatePendingCompactionBytes),
+                         db.int_property(rocksdb::DB::Properties::kNumRunningCompactions));
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    fmt::println("✓ Compactions settled after {} ms, L0 files: {}",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count(),
+                 db.int_property(rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0"));
+}
+
 // Structure to hold timing results for each round
 struct RoundResult {
     size_t round_number;
@@ -324,6 +558,9 @@ struct RoundResult {
     double tp99_write_latency_us = 0.0;
     double avg_mixed_latency_us = 0.0;
     double tp99_mixed_latency_us = 0.0;
+    
+    EngineTelemetry engine;
+    utils::PerfCounts perf;
 };
 
 // Calculate statistics from latency vectors
@@ -455,21 +692,54 @@ RoundResult perform_read_test(RocksDBBench& db, size_t round_number, const Bench
     
     result.read_latencies_us.reserve(config.test_kv_pairs);
     
-    for (size_t index : test_indices) {
-        std::string key = generate_key(index);
-        std::string value;
-        
-        auto op_start = std::chrono::high_resolution_clock::now();
-        bool found = db.get(key, value);
-        auto op_end = std::chrono::high_resolution_clock::now();
+    if (config.read_batch_size > 0) {
+        // Batched mode: the random keys are looked up read_batch_size at a time with DB::MultiGet, so latency is
+        // accounted per key as the duration of its batch divided by the batch size
+        fmt::println("Using batched reads: MultiGet batches of {}, async_io {}",
+                     config.read_batch_size, config.read_async_io);
         
-        if (found) {
-            result.successful_reads++;
+        std::vector<std::string> keys;
+        keys.reserve(test_indices.size());
+        for (size_t index : test_indices) {
+            keys.push_back(generate_key(index));
         }
+        // MultiGet walks the levels once per batch when its keys are sorted. Only each batch is sorted: sorting the
+        // whole round would make consecutive batches sweep the key space in order, unlike a random workload
+        for (size_t offset = 0; offset < keys.size(); offset += config.read_batch_size) {
+            const auto batch_begin = keys.begin() + static_cast<std::ptrdiff_t>(offset);
+            std::sort(batch_begin, batch_begin + static_cast<std::ptrdiff_t>(
+                                                     std::min(config.read_batch_size, keys.size() - offset)));
+        }
+        std::vector<rocksdb::Slice> key_slices(keys.begin(), keys.end());
         
-        double latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
-            op_end - op_start).count();
-        result.read_latencies_us.push_back(latency_us);
+        for (size_t offset = 0; offset < key_slices.size(); offset += config.read_batch_size) {
+            const size_t count = std::min(config.read_batch_size, key_slices.size() - offset);
+            
+            auto op_start = std::chrono::high_resolution_clock::now();
+            result.successful_reads += db.multi_get(std::span{key_slices}.subspan(offset, count), config.read_async_io);
+            auto op_end = std::chrono::high_resolution_clock::now();
+            
+            double latency_us = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                op_end - op_start).count() / 1000.0 / count;
+            result.read_latencies_us.insert(result.read_latencies_us.end(), count, latency_us);
+        }
+    } else {
+        for (size_t index : test_indices) {
+            std::string key = generate_key(index);
+            std::string value;
+            
+            auto op_start = std::chrono::high_resolution_clock::now();
+            bool found = db.get(key, value);
+            auto op_end = std::chrono::high_resolution_clock::now();
+            
+            if (found) {
+                result.successful_reads++;
+            }
+            
+            double latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                op_end - op_start).count();
+            result.read_latencies_us.push_back(latency_us);
+        }
     }
     
     auto read_end = std::chrono::high_resolution_clock::now();
@@ -841,32 +1111,67 @@ std::vector<RoundResult> run_comprehensive_benchmark(RocksDBBench& db, const Ben
     std::vector<RoundResult> results;
     results.reserve(config.test_rounds * 4); // 4 test modes
     
+    RocksDBTelemetry telemetry(db, std::chrono::milliseconds(config.telemetry_interval_ms));
+    
+    // Hardware counters of the foreground threads, the background jobs started with the DB are not counted
+    std::optional<utils::PerfCounters> perf;
+    if (config.perf_counters) {
+        perf.emplace();
+        if (!perf->available()) {
+            fmt::println("⚠ perf_event_open unavailable (check kernel.perf_event_paranoid), perf counters disabled");
+            perf.reset();
+        }
+    }
+    
+    auto run_round = [&](auto perform_test, size_t round) {
+        if (config.telemetry) {
+            telemetry.begin_round();
+        }
+        if (perf) {
+            perf->start();
+        }
+        auto result = perform_test(db, round, config);
+        if (perf) {
+            result.perf = perf->stop();
+            fmt::println("✓ Perf: {}", utils::format_perf_counts(result.perf, result.test_kv_count));
+        }
+        if (config.telemetry) {
+            result.engine = telemetry.end_round();
+            fmt::println("✓ Engine: pending compaction max {:.1f} MB, L0 files max {}, stalls {:.2f} ms, "
+                         "block cache hit rate {:.1f}%, write amplification {:.2f}",
+                         result.engine.max_pending_compaction_bytes / 1048576.0, result.engine.max_l0_files,
+                         result.engine.stall_micros / 1000.0, result.engine.block_cache_hit_rate * 100.0,
+                         result.engine.write_amplification);
+        }
+        results.push_back(std::move(result));
+    };
+    
     // Test Mode 1: Read-only tests
     fmt::println("\n--- READ-ONLY TESTS ---");
     for (size_t round = 1; round <= config.test_rounds; ++round) {
-        auto result = perform_read_test(db, round, config);
-        results.push_back(result);
+        run_round(perform_read_test, round);
     }
     
     // Test Mode 2: Write-only tests
     fmt::println("\n--- WRITE-ONLY TESTS ---");
     for (size_t round = 1; round <= config.test_rounds; ++round) {
-        auto result = perform_write_test(db, round, config);
-        results.push_back(result);
+        run_round(perform_write_test, round);
     }
     
     // Test Mode 3: Update tests
     fmt::println("\n--- UPDATE TESTS ---");
     for (size_t round = 1; round <= config.test_rounds; ++round) {
-        auto result = perform_update_test(db, round, config);
-        results.push_back(result);
+        run_round(perform_update_test, round);
     }
     
     // Test Mode 4: Mixed read-write tests
     fmt::println("\n--- MIXED READ-WRITE TESTS ---");
     for (size_t round = 1; round <= config.test_rounds; ++round) {
-        auto result = perform_mixed_test(db, round, config);
-        results.push_back(result);
+        run_round(perform_mixed_test, round);
+    }
+    
+    if (config.telemetry) {
+        fmt::println("\n✓ Write amplification since open: {:.2f}", telemetry.write_amplification());
     }
     
     return results;
@@ -964,6 +1269,17 @@ void print_comprehensive_summary(const std::vector<RoundResult>& results, const
                 total_commit_time += result.commit_time_ms;
                 total_operations += result.successful_mixed;
             }
+            if (result.engine.sampled) {
+                fmt::println("    Engine: PendingCompaction={:.1f}MB, L0={}, Compactions={}, Stalls={:.2f}ms{}, "
+                           "CacheHit={:.1f}%, WriteAmp={:.2f}",
+                           result.engine.max_pending_compaction_bytes / 1048576.0, result.engine.max_l0_files,
+                           result.engine.max_running_compactions, result.engine.stall_micros / 1000.0,
+                           result.engine.write_stopped ? " (stopped)" : "", result.engine.block_cache_hit_rate * 100.0,
+                           result.engine.write_amplification);
+            }
+            if (result.perf.captured()) {
+                fmt::println("    Perf: {}", utils::format_perf_counts(result.perf, result.test_kv_count));
+            }
         }
         
         double avg_avg_latency = total_avg_latency / mode_results.size();
@@ -1016,6 +1332,10 @@ void print_usage(const char* program_name) {
     fmt::println("  ROCKSDB_BENCH_TOTAL_KV_PAIRS  Total KV pairs in database");
     fmt::println("  ROCKSDB_BENCH_TEST_KV_PAIRS   KV pairs to test per round");
     fmt::println("  ROCKSDB_BENCH_TEST_ROUNDS     Number of test rounds");
+    fmt::println("  ROCKSDB_BENCH_LOAD_MODE       memtable (WriteBatch) or ingest (SST files)");
+    fmt::println("  ROCKSDB_BENCH_WAIT_FOR_COMPACTION  1 to wait for compactions before the read rounds");
+    fmt::println("  ROCKSDB_BENCH_READ_BATCH_SIZE Keys per MultiGet in read tests (0 = serial Get)");
+    fmt::println("  ROCKSDB_BENCH_PERF_COUNTERS   1 to count cycles, cache/TLB misses and page faults per round");
     fmt::println("  ROCKSDB_BENCH_DB_PATH         Database path");
     fmt::println("  Note: Key and value sizes are fixed at 32 bytes");
     fmt::println("");
@@ -1025,7 +1345,12 @@ void print_usage(const char* program_name) {
     fmt::println("  \"create_if_missing\": true,");
     fmt::println("  \"max_open_files\": 300,");
     fmt::println("  \"write_buffer_size\": 67108864,");
-    fmt::println("  \"max_write_buffer_number\": 3");
+    fmt::println("  \"max_write_buffer_number\": 3,");
+    fmt::println("  \"block_cache_size\": 536870912,");
+    fmt::println("  \"block_cache_type\": \"hyper_clock\",");
+    fmt::println("  \"bloom_bits_per_key\": 10,");
+    fmt::println("  \"partitioned_index_filters\": true,");
+    fmt::println("  \"compression_per_level\": [\"none\", \"none\", \"lz4\", \"lz4\", \"lz4\", \"lz4\", \"zstd\"]");
     fmt::println("}}");
     fmt::println("");
     fmt::println("Example BenchConfig JSON file:");
@@ -1084,7 +1409,14 @@ int main(int argc, char* argv[]) {
     fmt::println("Total KV pairs in DB: {}", bench_config.total_kv_pairs);
     fmt::println("KV pairs per test round: {}", bench_config.test_kv_pairs);
     fmt::println("Number of test rounds: {}", bench_config.test_rounds);
+    if (bench_config.read_batch_size > 0) {
+        fmt::println("Read mode: MultiGet batches of {} (async_io {})", bench_config.read_batch_size,
+                     bench_config.read_async_io);
+    }
     fmt::println("Database path: {}", bench_config.db_path);
+    fmt::println("Block cache: {} MB ({}), bloom bits/key: {}, partitioned index/filters: {}",
+                 rocksdb_config.block_cache_size >> 20, rocksdb_config.block_cache_type,
+                 rocksdb_config.bloom_bits_per_key, rocksdb_config.partitioned_index_filters);
     
     try {
         // Setup environment
@@ -1094,11 +1426,22 @@ int main(int argc, char* argv[]) {
         rocksdb_config.path = bench_config.db_path;
         
         // Open RocksDB database
-        RocksDBBench db(rocksdb_config);
+        RocksDBBench db(rocksdb_config, bench_config.telemetry);
         fmt::println("✓ Opened RocksDB database at: {}", rocksdb_config.path);
         
         // Populate database with initial data
-        populate_database(db, bench_config);
+        double load_time_ms = 0.0;
+        if (bench_config.load_mode == "ingest") {
+            load_time_ms = ingest_database(db, bench_config);
+        } else if (bench_config.load_mode == "memtable") {
+            load_time_ms = populate_database(db, bench_config);
+        } else {
+            throw std::runtime_error(fmt::format("Unknown load_mode: {}", bench_config.load_mode));
+        }
+        
+        if (bench_config.wait_for_compaction) {
+            wait_for_compaction(db, std::chrono::seconds(bench_config.compaction_wait_timeout_s));
+        }
         
         // Run comprehensive benchmark suite
         auto results = run_comprehensive_benchmark(db, bench_config);
@@ -1106,6 +1449,12 @@ int main(int argc, char* argv[]) {
         // Print comprehensive summary
         print_comprehensive_summary(results, bench_config);
         
+        // Load throughput, to compare the memtable and ingest paths across runs
+        fmt::println("\n--- LOAD ({}) ---", bench_config.load_mode);
+        fmt::println("Load time: {:.2f} s", load_time_ms / 1000.0);
+        fmt::println("Load throughput: {:.2f} KV pairs/sec",
+                     load_time_ms > 0 ? bench_config.total_kv_pairs / (load_time_ms / 1000.0) : 0.0);
+        
         fmt::println("\n✓ All benchmarks completed successfully! 🎉");
         
     } catch (const std::exception& e) {
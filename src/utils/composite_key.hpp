@@ -0,0 +1,85 @@
+#pragma once
+
+#include "utils/key_schema.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace utils {
+
+/**
+ * @brief Longest account name a CompositeKey can hold.
+ */
+inline constexpr size_t kMaxAccountNameLength = 128;
+
+/**
+ * @brief Fixed-capacity composite key `account_name + big_endian(block_number)` kept on the stack.
+ *
+ * The variable-length counterpart of KeySchema for the account state table, whose names are not
+ * fixed-size; the block suffix uses the BlockBE64 field codec.
+ *
+ * Replaces the std::vector<std::byte> previously built for every write and every lookup, so encoding
+ * a key never touches the heap. Usable in constant expressions.
+ */
+class CompositeKey {
+public:
+    static constexpr size_t kCapacity = kMaxAccountNameLength + sizeof(uint64_t);
+
+    /**
+     * @brief Whether a key can be built for account_name. Readers answer "not found" for names that do not fit,
+     * no such key can be stored.
+     */
+    static constexpr auto fits(std::string_view account_name) -> bool {
+        return account_name.size() <= kMaxAccountNameLength;
+    }
+
+    /**
+     * @brief Rejects an encoded `account_name + big_endian(block_number)` key the readers could not look up.
+     * @throws std::length_error if its account name is longer than kMaxAccountNameLength.
+     */
+    static constexpr void check_length(std::span<const std::byte> key) {
+        if (key.size() > kCapacity) {
+            throw std::length_error("CompositeKey: account name longer than kMaxAccountNameLength");
+        }
+    }
+
+    /**
+     * @brief Encodes the key for the given account and block.
+     * @throws std::length_error if account_name is longer than kMaxAccountNameLength.
+     */
+    constexpr CompositeKey(std::string_view account_name, uint64_t block_number) {
+        if (account_name.size() > kMaxAccountNameLength) {
+            throw std::length_error("CompositeKey: account name longer than kMaxAccountNameLength");
+        }
+        std::ranges::transform(account_name, buffer_.begin(), [](char c) { return static_cast<std::byte>(c); });
+        size_ = account_name.size() + sizeof(uint64_t);
+        set_block_number(block_number);
+    }
+
+    /**
+     * @brief Re-targets the key to another block of the same account.
+     */
+    constexpr void set_block_number(uint64_t block_number) {
+        BlockBE64::encode(buffer_.data() + account_size(), block_number);
+    }
+
+    constexpr auto block_number() const -> uint64_t { return BlockBE64::decode(buffer_.data() + account_size()); }
+
+    constexpr auto account_size() const -> size_t { return size_ - sizeof(uint64_t); }
+    constexpr auto size() const -> size_t { return size_; }
+    constexpr auto data() const -> const std::byte* { return buffer_.data(); }
+
+    constexpr auto bytes() const -> std::span<const std::byte> { return {buffer_.data(), size_}; }
+    constexpr operator std::span<const std::byte>() const { return bytes(); }  // NOLINT(google-explicit-constructor)
+
+private:
+    std::array<std::byte, kCapacity> buffer_{};
+    size_t size_ = 0;
+};
+
+} // namespace utils
@@ -4,8 +4,8 @@
 #include <array>
 #include <bit>        // For std::endian and std::byteswap
 #include <cstdint>
+#include <cstring>    // For std::memcpy
 #include <span>
-#include <cstdint>
 
 namespace utils {
 
@@ -17,22 +17,61 @@ namespace utils {
  * @param value The integer value to convert.
  * @return A std::array of 8 bytes representing the integer in big-endian format.
  */
-inline auto to_big_endian_bytes(uint64_t value) -> std::array<std::byte, 8> {
+constexpr auto to_big_endian_bytes(uint64_t value) -> std::array<std::byte, 8> {
     const uint64_t be_value = (std::endian::native == std::endian::little) ? std::byteswap(value) : value;
     return std::bit_cast<std::array<std::byte, 8>>(be_value);
 }
 
+/**
+ * @brief Reads a 64-bit unsigned integer stored in big-endian order at the given address.
+ *
+ * The bytes are loaded in place (a single unaligned load plus byteswap), no temporary array is involved,
+ * which makes it suitable for decoding the block number suffix of keys straight out of the database pages.
+ *
+ * @param data Pointer to at least 8 readable bytes.
+ * @return The decoded integer value.
+ */
+constexpr auto load_big_endian_u64(const std::byte* data) -> uint64_t {
+    if consteval {
+        uint64_t value = 0;
+        for (size_t i = 0; i < sizeof(value); ++i) {
+            value = (value << 8) | std::to_integer<uint64_t>(data[i]);
+        }
+        return value;
+    } else {
+        uint64_t be_value;
+        std::memcpy(&be_value, data, sizeof(be_value));
+        return (std::endian::native == std::endian::little) ? std::byteswap(be_value) : be_value;
+    }
+}
+
+/**
+ * @brief Writes a 64-bit unsigned integer in big-endian order at the given address.
+ *
+ * The in-place counterpart of to_big_endian_bytes, used to encode keys directly into their final buffer.
+ *
+ * @param data Pointer to at least 8 writable bytes.
+ * @param value The integer value to store.
+ */
+constexpr void store_big_endian_u64(std::byte* data, uint64_t value) {
+    if consteval {
+        for (size_t i = 0; i < sizeof(value); ++i) {
+            data[i] = static_cast<std::byte>(value >> (56 - 8 * i));
+        }
+    } else {
+        const uint64_t be_value = (std::endian::native == std::endian::little) ? std::byteswap(value) : value;
+        std::memcpy(data, &be_value, sizeof(be_value));
+    }
+}
+
 /**
  * @brief Converts a span of 8 bytes in big-endian order back to a 64-bit unsigned integer.
  *
  * @param data A span of exactly 8 bytes representing the integer in big-endian format.
  * @return The converted integer value.
  */
-inline auto from_big_endian_bytes(std::span<const std::byte, 8> data) -> uint64_t {
-    std::array<std::byte, 8> byte_array;
-    std::copy(data.begin(), data.end(), byte_array.begin());
-    const auto be_value = std::bit_cast<uint64_t>(byte_array);
-    return (std::endian::native == std::endian::little) ? std::byteswap(be_value) : be_value;
+constexpr auto from_big_endian_bytes(std::span<const std::byte, 8> data) -> uint64_t {
+    return load_big_endian_u64(data.data());
 }
 
 } // namespace utils
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "utils/simd_compare.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace utils {
+
+/**
+ * @brief Maximum number of versions stored in one history chunk before it is split.
+ */
+inline constexpr size_t kMaxHistoryChunkEntries = 64;
+
+/**
+ * @brief One version of a history chunk: the state of an account as of a block.
+ */
+struct HistoryEntry {
+    uint64_t block_number;
+    std::span<const std::byte> value;
+};
+
+/**
+ * @brief Appends the LEB128 (7 bits per byte, little-endian groups) encoding of value.
+ */
+inline void append_varint(std::vector<std::byte>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::byte>(value));
+}
+
+/**
+ * @brief Decodes a LEB128 value at the front of data and advances data past it.
+ * @throws std::runtime_error if data is truncated or the value overflows 64 bits.
+ */
+inline auto read_varint(std::span<const std::byte>& data) -> uint64_t {
+    uint64_t value = 0;
+    for (size_t i = 0; i < data.size() && i < 10; ++i) {
+        const auto byte = std::to_integer<uint64_t>(data[i]);
+        value |= (byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            data = data.subspan(i + 1);
+            return value;
+        }
+    }
+    throw std::runtime_error("History chunk: truncated or overlong varint");
+}
+
+/**
+ * @brief Encodes versions sorted by strictly ascending block number into a history chunk value.
+ *
+ * Layout: `varint(count)`, `varint(first block)`, `varint(block delta)` for each following version,
+ * `varint(value size)` for each version, then the value bytes back to back. Consecutive versions of an
+ * account are usually a few blocks apart, so each block number takes 1-2 bytes instead of 8 plus a key.
+ */
+inline auto encode_history_chunk(std::span<const HistoryEntry> entries) -> std::vector<std::byte> {
+    if (entries.empty() || entries.size() > kMaxHistoryChunkEntries) {
+        throw std::invalid_argument("History chunk: invalid number of entries");
+    }
+    size_t value_bytes = 0;
+    for (const auto& entry : entries) {
+        if (entry.value.size() > UINT32_MAX) {
+            throw std::invalid_argument("History chunk: value too large");
+        }
+        value_bytes += entry.value.size();
+    }
+    std::vector<std::byte> out;
+    out.reserve(1 + entries.size() * 4 + value_bytes);
+
+    append_varint(out, entries.size());
+    uint64_t previous = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i > 0 && entries[i].block_number <= previous) {
+            throw std::invalid_argument("History chunk: block numbers must be strictly ascending");
+        }
+        append_varint(out, entries[i].block_number - previous);
+        previous = entries[i].block_number;
+    }
+    for (const auto& entry : entries) {
+        append_varint(out, entry.value.size());
+    }
+    for (const auto& entry : entries) {
+        out.insert(out.end(), entry.value.begin(), entry.value.end());
+    }
+    return out;
+}
+
+/**
+ * @brief Zero-copy reader of an encoded history chunk.
+ *
+ * Block numbers are decoded into an inline array once; values are spans into the encoded bytes, so they
+ * live as long as the buffer the view was built on (e.g. the database page within a transaction).
+ */
+class HistoryChunkView {
+public:
+    /**
+     * @throws std::runtime_error if encoded is not a valid history chunk.
+     */
+    explicit HistoryChunkView(std::span<const std::byte> encoded) {
+        std::span<const std::byte> data = encoded;
+        const uint64_t count = read_varint(data);
+        if (count == 0 || count > kMaxHistoryChunkEntries) {
+            throw std::runtime_error("History chunk: invalid number of entries");
+        }
+        size_ = static_cast<size_t>(count);
+
+        uint64_t block = 0;
+        for (size_t i = 0; i < size_; ++i) {
+            block += read_varint(data);
+            blocks_[i] = block;
+        }
+        size_t value_bytes = 0;
+        for (size_t i = 0; i < size_; ++i) {
+            const uint64_t value_size = read_varint(data);
+            if (value_size > UINT32_MAX) {
+                throw std::runtime_error("History chunk: value too large");
+            }
+            sizes_[i] = static_cast<uint32_t>(value_size);
+            value_bytes += sizes_[i];
+        }
+        if (data.size() != value_bytes) {
+            throw std::runtime_error("History chunk: value bytes do not match value sizes");
+        }
+        values_ = data;
+    }
+
+    auto size() const -> size_t { return size_; }
+    auto block_number(size_t index) const -> uint64_t { return blocks_[index]; }
+    auto first_block() const -> uint64_t { return blocks_[0]; }
+    auto last_block() const -> uint64_t { return blocks_[size_ - 1]; }
+
+    auto entry(size_t index) const -> HistoryEntry {
+        size_t offset = 0;
+        for (size_t i = 0; i < index; ++i) {
+            offset += sizes_[i];
+        }
+        return HistoryEntry{blocks_[index], values_.subspan(offset, sizes_[index])};
+    }
+
+    auto last() const -> HistoryEntry { return entry(size_ - 1); }
+
+    /**
+     * @brief Finds the version with the largest block number <= target.
+     * @return The version, or std::nullopt if every version of the chunk is above target.
+     */
+    auto find_less_equal(uint64_t target) const -> std::optional<HistoryEntry> {
+        const size_t count = count_less_equal(blocks_.data(), size_, target);
+        if (count == 0) {
+            return std::nullopt;
+        }
+        return entry(count - 1);
+    }
+
+    /**
+     * @brief Returns all the versions, e.g. to rewrite the chunk.
+     */
+    auto entries() const -> std::vector<HistoryEntry> {
+        std::vector<HistoryEntry> out;
+        out.reserve(size_);
+        size_t offset = 0;
+        for (size_t i = 0; i < size_; ++i) {
+            out.push_back(HistoryEntry{blocks_[i], values_.subspan(offset, sizes_[i])});
+            offset += sizes_[i];
+        }
+        return out;
+    }
+
+private:
+    std::array<uint64_t, kMaxHistoryChunkEntries> blocks_;
+    std::array<uint32_t, kMaxHistoryChunkEntries> sizes_;
+    std::span<const std::byte> values_;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Inserts a version into entries sorted by block number, replacing the one of the same block if any.
+ */
+inline void upsert_history_entry(std::vector<HistoryEntry>& entries, HistoryEntry entry) {
+    const auto it = std::ranges::lower_bound(entries, entry.block_number, {}, &HistoryEntry::block_number);
+    if (it != entries.end() && it->block_number == entry.block_number) {
+        it->value = entry.value;
+    } else {
+        entries.insert(it, entry);
+    }
+}
+
+} // namespace utils
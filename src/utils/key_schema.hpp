@@ -0,0 +1,197 @@
+#pragma once
+
+#include "utils/endian.hpp"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace utils {
+
+/**
+ * @brief A fixed-size field of a KeySchema.
+ *
+ * Provides its encoded size, the C++ type it decodes to, and constexpr encode/decode functions
+ * writing/reading exactly kSize bytes so that the encoding sorts bytewise like the values.
+ */
+template <typename F>
+concept KeyField = requires(std::byte* out, const std::byte* in, const typename F::value_type& value) {
+    { F::kSize } -> std::convertible_to<size_t>;
+    { F::encode(out, value) };
+    { F::decode(in) } -> std::same_as<typename F::value_type>;
+};
+
+/**
+ * @brief Opaque fixed-size byte string field (addresses, hashes), copied verbatim.
+ */
+template <size_t N>
+struct FixedBytes {
+    using value_type = std::array<std::byte, N>;
+    static constexpr size_t kSize = N;
+
+    static constexpr void encode(std::byte* out, const value_type& value) { std::ranges::copy(value, out); }
+    static constexpr auto decode(const std::byte* in) -> value_type {
+        value_type value{};
+        std::copy_n(in, N, value.begin());
+        return value;
+    }
+};
+
+/**
+ * @brief Unsigned integer field stored big-endian, so that bytewise order matches numeric order.
+ */
+template <std::unsigned_integral T>
+struct BigEndian {
+    using value_type = T;
+    static constexpr size_t kSize = sizeof(T);
+
+    static constexpr void encode(std::byte* out, T value) {
+        if constexpr (sizeof(T) == sizeof(uint64_t)) {
+            store_big_endian_u64(out, value);
+        } else {
+            for (size_t i = 0; i < kSize; ++i) {
+                out[i] = static_cast<std::byte>(value >> (8 * (kSize - 1 - i)));
+            }
+        }
+    }
+    static constexpr auto decode(const std::byte* in) -> T {
+        if constexpr (sizeof(T) == sizeof(uint64_t)) {
+            return load_big_endian_u64(in);
+        } else {
+            T value = 0;
+            for (size_t i = 0; i < kSize; ++i) {
+                value = static_cast<T>((value << 8) | std::to_integer<T>(in[i]));
+            }
+            return value;
+        }
+    }
+};
+
+using Address20 = FixedBytes<20>;
+using Hash32 = FixedBytes<32>;
+using BlockBE64 = BigEndian<uint64_t>;
+
+/**
+ * @brief Compile-time description of a fixed-size key made of concatenated fields.
+ *
+ * Every offset and size is a constant, so encode/decode/prefix inline down to plain loads and stores.
+ * Example: `using StorageKey = KeySchema<Address20, Hash32, BlockBE64>;`
+ */
+template <KeyField... Fields>
+class KeySchema {
+public:
+    static_assert(sizeof...(Fields) > 0, "KeySchema needs at least one field");
+
+    static constexpr size_t kFieldCount = sizeof...(Fields);
+    static constexpr size_t kSize = (Fields::kSize + ...);
+
+    using Key = std::array<std::byte, kSize>;
+    using Values = std::tuple<typename Fields::value_type...>;
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    /**
+     * @brief Byte offset of field I, which is also the size of the prefix made of the I leading fields.
+     */
+    template <size_t I>
+    static constexpr size_t kOffset = [] {
+        constexpr std::array<size_t, kFieldCount> sizes{Fields::kSize...};
+        size_t offset = 0;
+        for (size_t i = 0; i < I; ++i) {
+            offset += sizes[i];
+        }
+        return offset;
+    }();
+
+    /**
+     * @brief Encodes all the fields into a key.
+     */
+    static constexpr auto encode(const typename Fields::value_type&... values) -> Key {
+        Key key{};
+        encode_fields(key.data(), std::index_sequence_for<Fields...>{}, values...);
+        return key;
+    }
+
+    /**
+     * @brief Encodes the N leading fields, N < kFieldCount, into a key prefix for range scans.
+     */
+    template <typename... Prefix>
+        requires(sizeof...(Prefix) < kFieldCount)
+    static constexpr auto prefix(const Prefix&... values) -> std::array<std::byte, kOffset<sizeof...(Prefix)>> {
+        std::array<std::byte, kOffset<sizeof...(Prefix)>> out{};
+        encode_prefix(out.data(), std::index_sequence_for<Prefix...>{}, values...);
+        return out;
+    }
+
+    /**
+     * @brief Decodes field I of a key.
+     */
+    template <size_t I>
+    static constexpr auto get(std::span<const std::byte, kSize> key) -> typename Field<I>::value_type {
+        return Field<I>::decode(key.data() + kOffset<I>);
+    }
+
+    /**
+     * @brief Decodes all the fields of a key.
+     */
+    static constexpr auto decode(std::span<const std::byte, kSize> key) -> Values {
+        return decode_fields(key, std::index_sequence_for<Fields...>{});
+    }
+
+    /**
+     * @brief Checks whether a runtime key has the size of this schema and can be decoded.
+     */
+    static constexpr auto matches(std::span<const std::byte> key) -> bool { return key.size() == kSize; }
+
+    /**
+     * @brief Turns a key or prefix into the smallest byte string of the same size sorting after all
+     * the keys it prefixes, i.e. the exclusive upper bound of a prefix scan.
+     * @return false if the input is all 0xFF bytes (no such successor, the scan is unbounded).
+     */
+    template <size_t N>
+    static constexpr auto successor(std::array<std::byte, N>& bytes) -> bool {
+        for (size_t i = N; i-- > 0;) {
+            bytes[i] = static_cast<std::byte>(std::to_integer<uint8_t>(bytes[i]) + 1);
+            if (bytes[i] != std::byte{0}) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    template <size_t... I>
+    static constexpr void encode_fields(std::byte* out, std::index_sequence<I...>,
+                                        const typename Fields::value_type&... values) {
+        (Fields::encode(out + kOffset<I>, values), ...);
+    }
+
+    template <size_t... I, typename... Prefix>
+    static constexpr void encode_prefix(std::byte* out, std::index_sequence<I...>, const Prefix&... values) {
+        (Field<I>::encode(out + kOffset<I>, static_cast<const typename Field<I>::value_type&>(values)), ...);
+    }
+
+    template <size_t... I>
+    static constexpr auto decode_fields(std::span<const std::byte, kSize> key, std::index_sequence<I...>) -> Values {
+        return Values{get<I>(key)...};
+    }
+};
+
+/**
+ * @brief (address ‖ block) key of account history tables.
+ */
+using AccountHistoryKey = KeySchema<Address20, BlockBE64>;
+
+/**
+ * @brief (address ‖ slot ‖ block) key of storage history tables.
+ */
+using StorageHistoryKey = KeySchema<Address20, Hash32, BlockBE64>;
+
+} // namespace utils
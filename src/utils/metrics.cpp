@@ -0,0 +1,235 @@
+#include "utils/metrics.hpp"
+
+#include <fmt/format.h>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace utils {
+
+namespace metrics_detail {
+
+std::atomic<uint32_t> metrics_sample_rate{0};
+
+namespace {
+
+std::mutex shards_mutex;
+std::vector<size_t> free_shards;
+size_t next_shard{0};
+
+} // namespace
+
+auto acquire_metric_shard() -> size_t {
+    std::lock_guard lock{shards_mutex};
+    if (!free_shards.empty()) {
+        const size_t shard = free_shards.back();
+        free_shards.pop_back();
+        return shard;
+    }
+    if (next_shard < kSharedMetricShard) {
+        return next_shard++;
+    }
+    return kSharedMetricShard;
+}
+
+void release_metric_shard(size_t shard) {
+    if (shard == kSharedMetricShard) {
+        return;
+    }
+    // The counts of the shard stay, its next owner adds to them
+    std::lock_guard lock{shards_mutex};
+    free_shards.push_back(shard);
+}
+
+} // namespace metrics_detail
+
+void enable_metrics(uint32_t latency_sample_rate) {
+    metrics_detail::metrics_sample_rate = std::max<uint32_t>(latency_sample_rate, 1);
+}
+
+void disable_metrics() {
+    metrics_detail::metrics_sample_rate = 0;
+}
+
+auto Counter::value() const noexcept -> uint64_t {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+auto Histogram::snapshot() const noexcept -> Snapshot {
+    Snapshot snapshot;
+    for (const auto& shard : shards_) {
+        for (size_t i = 0; i < kBuckets; ++i) {
+            const uint64_t count = shard.buckets[i].load(std::memory_order_relaxed);
+            snapshot.buckets[i] += count;
+            snapshot.count += count;
+        }
+        snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+// --- MetricsRegistry ---
+auto MetricsRegistry::instance() -> MetricsRegistry& {
+    // Never destroyed: thread_local destructors and static destructors of other modules may still record
+    static auto* registry = new MetricsRegistry;
+    return *registry;
+}
+
+auto MetricsRegistry::series(std::string_view name, std::string_view labels, std::string_view help, Type type)
+    -> Series& {
+    std::lock_guard lock{mutex_};
+    auto it = families_.find(name);
+    if (it == families_.end()) {
+        it = families_.emplace(std::string{name}, Family{type, std::string{help}, {}}).first;
+    } else if (it->second.type != type) {
+        throw std::logic_error(fmt::format("Metric {} already registered with another type", name));
+    }
+    auto& family = it->second;
+    for (auto& series : family.series) {
+        if (series.labels == labels) {
+            return series;
+        }
+    }
+    auto& series = family.series.emplace_back(Series{std::string{labels}, nullptr, nullptr, nullptr});
+    switch (type) {
+        case Type::kCounter:
+            series.counter = std::make_unique<Counter>();
+            break;
+        case Type::kGauge:
+            series.gauge = std::make_unique<Gauge>();
+            break;
+        case Type::kHistogram:
+            series.histogram = std::make_unique<Histogram>();
+            break;
+    }
+    return series;
+}
+
+auto MetricsRegistry::counter(std::string_view name, std::string_view labels, std::string_view help) -> Counter& {
+    return *series(name, labels, help, Type::kCounter).counter;
+}
+
+auto MetricsRegistry::gauge(std::string_view name, std::string_view labels, std::string_view help) -> Gauge& {
+    return *series(name, labels, help, Type::kGauge).gauge;
+}
+
+auto MetricsRegistry::histogram(std::string_view name, std::string_view labels, std::string_view help)
+    -> Histogram& {
+    return *series(name, labels, help, Type::kHistogram).histogram;
+}
+
+auto MetricsRegistry::dump() const -> std::string {
+    auto braces = [](const std::string& labels) { return labels.empty() ? std::string{} : "{" + labels + "}"; };
+
+    static constexpr const char* kTypeNames[] = {"counter", "gauge", "histogram"};
+
+    std::string out;
+    std::lock_guard lock{mutex_};
+    for (const auto& [name, family] : families_) {
+        fmt::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n", name, family.help, name,
+                       kTypeNames[static_cast<int>(family.type)]);
+        for (const auto& series : family.series) {
+            if (series.counter) {
+                fmt::format_to(std::back_inserter(out), "{}{} {}\n", name, braces(series.labels),
+                               series.counter->value());
+            } else if (series.gauge) {
+                fmt::format_to(std::back_inserter(out), "{}{} {}\n", name, braces(series.labels),
+                               series.gauge->value());
+            } else {
+                const auto snapshot = series.histogram->snapshot();
+                const std::string separator = series.labels.empty() ? "" : ",";
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i + 1 < Histogram::kBuckets; ++i) {
+                    cumulative += snapshot.buckets[i];
+                    fmt::format_to(std::back_inserter(out), "{}_bucket{{{}{}le=\"{}\"}} {}\n", name, series.labels,
+                                   separator, static_cast<double>(uint64_t{1} << i) * 1e-9, cumulative);
+                }
+                fmt::format_to(std::back_inserter(out), "{}_bucket{{{}{}le=\"+Inf\"}} {}\n", name, series.labels,
+                               separator, snapshot.count);
+                fmt::format_to(std::back_inserter(out), "{}_sum{} {}\n{}_count{} {}\n", name, braces(series.labels),
+                               static_cast<double>(snapshot.sum) * 1e-9, name, braces(series.labels),
+                               snapshot.count);
+            }
+        }
+    }
+    return out;
+}
+
+// --- MetricsEndpoint ---
+MetricsEndpoint::MetricsEndpoint(std::filesystem::path socket_path) : socket_path_{std::move(socket_path)} {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = socket_path_.string();
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error(fmt::format("Metrics socket path too long: {}", path));
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        throw std::runtime_error(fmt::format("Metrics socket creation failed: {}", std::strerror(errno)));
+    }
+    std::filesystem::remove(socket_path_);  // Left over by a previous process
+    if (::bind(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd_, 8) != 0) {
+        const int error = errno;
+        ::close(fd_);
+        throw std::runtime_error(fmt::format("Metrics socket {} bind failed: {}", path, std::strerror(error)));
+    }
+    thread_ = std::jthread{[this](std::stop_token stop) { run(stop); }};
+}
+
+MetricsEndpoint::~MetricsEndpoint() {
+    thread_.request_stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    ::close(fd_);
+    std::error_code ignored;
+    std::filesystem::remove(socket_path_, ignored);
+}
+
+void MetricsEndpoint::run(const std::stop_token& stop) {
+    while (!stop.stop_requested()) {
+        // Wake up regularly to notice the stop request
+        pollfd listener{fd_, POLLIN, 0};
+        if (::poll(&listener, 1, 200) <= 0) {
+            continue;
+        }
+        const int client = ::accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;
+        }
+        // Consume the request line and headers if any, a slow client only delays its own response
+        pollfd request{client, POLLIN, 0};
+        if (::poll(&request, 1, 100) > 0) {
+            char buffer[4096];
+            [[maybe_unused]] const auto ignored = ::recv(client, buffer, sizeof(buffer), MSG_DONTWAIT);
+        }
+        const std::string body = MetricsRegistry::instance().dump();
+        const std::string response = fmt::format(
+            "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: {}\r\n\r\n{}", body.size(),
+            body);
+        size_t sent = 0;
+        while (sent < response.size()) {
+            const auto written = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(written);
+        }
+        ::close(client);
+    }
+}
+
+} // namespace utils
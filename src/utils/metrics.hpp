@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace utils {
+
+namespace metrics_detail {
+
+/**
+ * @brief Shards of each counter and histogram. Each thread owns one, threads beyond kMetricShards - 1 share the last.
+ */
+inline constexpr size_t kMetricShards = 32;
+inline constexpr size_t kSharedMetricShard = kMetricShards - 1;
+
+// Latency sampling period, zero while metrics are disabled
+extern std::atomic<uint32_t> metrics_sample_rate;
+
+auto acquire_metric_shard() -> size_t;
+void release_metric_shard(size_t shard);
+
+// Shard of the calling thread, given back to the free list when the thread exits
+inline auto metric_shard() -> size_t {
+    struct Owner {
+        size_t shard{acquire_metric_shard()};
+        ~Owner() {
+            release_metric_shard(shard);
+            shard = kSharedMetricShard;  // For the thread_local destructors recording after this one
+        }
+    };
+    thread_local Owner owner;
+    return owner.shard;
+}
+
+// An owned shard is only written by its thread: a plain load and store, no locked instruction
+inline void shard_add(std::atomic<uint64_t>& value, size_t shard, uint64_t n) {
+    if (shard == kSharedMetricShard) [[unlikely]] {
+        value.fetch_add(n, std::memory_order_relaxed);
+    } else {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+}
+
+// Whether the calling thread times this operation, one out of metrics_sample_rate
+inline auto sample_latency() -> bool {
+    const uint32_t rate = metrics_sample_rate.load(std::memory_order_relaxed);
+    if (rate == 0) [[likely]] return false;
+    thread_local uint32_t countdown{0};
+    if (countdown > 0) {
+        --countdown;
+        return false;
+    }
+    countdown = rate - 1;
+    return true;
+}
+
+} // namespace metrics_detail
+
+/**
+ * @brief Starts recording metrics.
+ * @param latency_sample_rate Time one operation out of this many per thread; counters see every operation.
+ */
+void enable_metrics(uint32_t latency_sample_rate = 16);
+
+/**
+ * @brief Stops recording metrics, the values recorded so far are kept.
+ */
+void disable_metrics();
+
+inline auto metrics_enabled() -> bool {
+    return metrics_detail::metrics_sample_rate.load(std::memory_order_relaxed) != 0;
+}
+
+/**
+ * @brief Monotonic counter, sharded per thread so that increments never contend.
+ */
+class Counter {
+public:
+    void add(uint64_t n = 1) noexcept {
+        const size_t shard = metrics_detail::metric_shard();
+        metrics_detail::shard_add(shards_[shard].value, shard, n);
+    }
+
+    auto value() const noexcept -> uint64_t;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, metrics_detail::kMetricShards> shards_{};
+};
+
+/**
+ * @brief Value that goes up and down, for levels set from a single place (queue depths, open transactions).
+ */
+class Gauge {
+public:
+    void set(int64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+    void add(int64_t n) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    auto value() const noexcept -> int64_t { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+/**
+ * @brief Distribution of durations in nanoseconds over power-of-two buckets, exposed in seconds.
+ */
+class Histogram {
+public:
+    // Bucket i counts the durations below 2^i ns, the last one also the longer ones (above ~17s)
+    static constexpr size_t kBuckets = 36;
+
+    struct Snapshot {
+        std::array<uint64_t, kBuckets> buckets{};
+        uint64_t count{0};
+        uint64_t sum{0};  // Nanoseconds
+    };
+
+    void observe(uint64_t nanos) noexcept {
+        const size_t shard = metrics_detail::metric_shard();
+        auto& counts = shards_[shard];
+        const size_t bucket = std::min<size_t>(std::bit_width(nanos), kBuckets - 1);
+        metrics_detail::shard_add(counts.buckets[bucket], shard, 1);
+        metrics_detail::shard_add(counts.sum, shard, nanos);
+    }
+
+    auto snapshot() const noexcept -> Snapshot;
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+        std::atomic<uint64_t> sum{0};
+    };
+    std::array<Shard, metrics_detail::kMetricShards> shards_{};
+};
+
+/**
+ * @brief Times the enclosing scope into a histogram, for one call out of the latency sampling period.
+ */
+class ScopedLatency {
+public:
+    explicit ScopedLatency(Histogram& histogram) noexcept
+        : histogram_{metrics_detail::sample_latency() ? &histogram : nullptr} {
+        if (histogram_ != nullptr) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedLatency() {
+        if (histogram_ != nullptr) {
+            const auto elapsed = std::chrono::steady_clock::now() - start_;
+            histogram_->observe(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    Histogram* histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief Process-wide set of metrics, rendered in the Prometheus text exposition format.
+ *
+ * Metrics are registered once, typically into a function-local static of the instrumented module, and live until the
+ * process exits: recording through the returned references takes no lock.
+ */
+class MetricsRegistry {
+public:
+    static auto instance() -> MetricsRegistry&;
+
+    /**
+     * @brief Returns the series of a metric family, registering it on first use.
+     * @param name Family name, e.g. "db_ops_total".
+     * @param labels Label pairs of the series, e.g. `backend="mdbx",op="get_state"`, empty for none.
+     * @param help Description of the family, kept from its first registration.
+     * @throws std::logic_error if the family has been registered with another type.
+     */
+    auto counter(std::string_view name, std::string_view labels, std::string_view help) -> Counter&;
+    auto gauge(std::string_view name, std::string_view labels, std::string_view help) -> Gauge&;
+    auto histogram(std::string_view name, std::string_view labels, std::string_view help) -> Histogram&;
+
+    /**
+     * @brief Renders all the metrics in the Prometheus text format (version 0.0.4).
+     */
+    auto dump() const -> std::string;
+
+private:
+    enum class Type { kCounter, kGauge, kHistogram };
+
+    struct Series {
+        std::string labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family {
+        Type type;
+        std::string help;
+        std::deque<Series> series;  // Grows without moving the series handed out
+    };
+
+    auto series(std::string_view name, std::string_view labels, std::string_view help, Type type) -> Series&;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family, std::less<>> families_;
+};
+
+/**
+ * @brief Serves MetricsRegistry::dump() over HTTP on a Unix domain socket.
+ *
+ * Scrape with e.g. `curl --unix-socket <socket_path> http://localhost/metrics`; every request gets the full dump.
+ */
+class MetricsEndpoint {
+public:
+    /**
+     * @throws std::runtime_error if the socket cannot be bound.
+     */
+    explicit MetricsEndpoint(std::filesystem::path socket_path);
+    ~MetricsEndpoint();
+
+    MetricsEndpoint(const MetricsEndpoint&) = delete;
+    MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+private:
+    void run(const std::stop_token& stop);
+
+    std::filesystem::path socket_path_;
+    int fd_{-1};
+    std::jthread thread_;
+};
+
+} // namespace utils
@@ -0,0 +1,152 @@
+#include "utils/perf_counters.hpp"
+
+#include <fmt/format.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+namespace utils {
+
+#if defined(__linux__)
+
+namespace {
+
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cache_read_miss(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// In the order of the PerfCounts fields
+constexpr std::array<EventSpec, 7> kEventSpecs = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_DTLB)},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MIN},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+}};
+
+int open_event(const EventSpec& spec, bool exclude_kernel) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = 1;
+    attr.inherit = 1;  // Also count the threads created after opening (readers, prefetchers, background jobs)
+    attr.exclude_kernel = exclude_kernel ? 1 : 0;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+    for (size_t i = 0; i < kEvents; ++i) {
+        // Page faults are taken in the kernel: count kernel time when allowed, user time only otherwise
+        fds_[i] = open_event(kEventSpecs[i], /*exclude_kernel=*/false);
+        if (fds_[i] < 0) {
+            fds_[i] = open_event(kEventSpecs[i], /*exclude_kernel=*/true);
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+auto PerfCounters::available() const -> bool {
+    return std::any_of(fds_.begin(), fds_.end(), [](int fd) { return fd >= 0; });
+}
+
+void PerfCounters::start() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+auto PerfCounters::stop() -> PerfCounts {
+    std::array<std::optional<uint64_t>, kEvents> values;
+    for (size_t i = 0; i < kEvents; ++i) {
+        if (fds_[i] < 0) {
+            continue;
+        }
+        ::ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t data[3] = {};  // value, time enabled, time running
+        if (::read(fds_[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+            continue;  // Never scheduled on the PMU
+        }
+        values[i] = data[2] == data[1]
+                        ? data[0]
+                        : static_cast<uint64_t>(static_cast<double>(data[0]) * static_cast<double>(data[1]) /
+                                                static_cast<double>(data[2]));
+    }
+    return PerfCounts{values[0], values[1], values[2], values[3], values[4], values[5], values[6]};
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+auto PerfCounters::available() const -> bool {
+    return false;
+}
+
+void PerfCounters::start() {}
+
+auto PerfCounters::stop() -> PerfCounts {
+    return {};
+}
+
+#endif
+
+auto format_perf_counts(const PerfCounts& counts, uint64_t operations) -> std::string {
+    const double ops = static_cast<double>(std::max<uint64_t>(operations, 1));
+    std::string out;
+    auto append = [&](const char* name, const std::optional<uint64_t>& value) {
+        if (!value) {
+            return;
+        }
+        fmt::format_to(std::back_inserter(out), "{}{}/op={:.2f}", out.empty() ? "" : ", ", name,
+                       static_cast<double>(*value) / ops);
+    };
+    append("cycles", counts.cycles);
+    append("instructions", counts.instructions);
+    if (counts.cycles && counts.instructions && *counts.cycles > 0) {
+        fmt::format_to(std::back_inserter(out), ", IPC={:.2f}",
+                       static_cast<double>(*counts.instructions) / static_cast<double>(*counts.cycles));
+    }
+    append("LLC-misses", counts.llc_misses);
+    append("dTLB-misses", counts.dtlb_misses);
+    append("major-faults", counts.major_faults);
+    append("minor-faults", counts.minor_faults);
+    if (counts.context_switches) {
+        fmt::format_to(std::back_inserter(out), "{}context-switches={}", out.empty() ? "" : ", ",
+                       *counts.context_switches);
+    }
+    return out.empty() ? std::string{"no events counted"} : out;
+}
+
+} // namespace utils
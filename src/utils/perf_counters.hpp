@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace utils {
+
+/**
+ * @brief Hardware and software event counts of the process over an interval, nullopt for the events not counted.
+ */
+struct PerfCounts {
+    std::optional<uint64_t> cycles;
+    std::optional<uint64_t> instructions;
+    std::optional<uint64_t> llc_misses;        // Last level cache read misses
+    std::optional<uint64_t> dtlb_misses;       // Data TLB read misses
+    std::optional<uint64_t> major_faults;      // Page faults that had to read from disk
+    std::optional<uint64_t> minor_faults;      // Page faults served from the page cache (mapping setup)
+    std::optional<uint64_t> context_switches;
+
+    auto captured() const -> bool {
+        return cycles || instructions || llc_misses || dtlb_misses || major_faults || minor_faults || context_switches;
+    }
+};
+
+/**
+ * @brief Counts hardware and software events of the calling process with perf_event_open(2).
+ *
+ * The events follow the calling thread and the threads it creates afterwards, whose counts are added when they exit:
+ * threads joined before stop() are included, long-lived ones (e.g. RocksDB background jobs) are not.
+ * Events the kernel or the CPU does not provide (no PMU in a VM, perf_event_paranoid too high) are left out: on
+ * non-Linux builds, or when none can be opened, available() is false and stop() returns empty counts.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    auto available() const -> bool;
+
+    /**
+     * @brief Resets and starts all the counters.
+     */
+    void start();
+
+    /**
+     * @brief Stops the counters and returns the counts since start(), scaled when the PMU was multiplexed.
+     */
+    auto stop() -> PerfCounts;
+
+private:
+    static constexpr size_t kEvents = 7;
+    std::array<int, kEvents> fds_;
+};
+
+/**
+ * @brief Formats counts divided by the operations of the interval, e.g. "cycles/op=1523.4, IPC=0.61, ...".
+ */
+auto format_perf_counts(const PerfCounts& counts, uint64_t operations) -> std::string;
+
+} // namespace utils
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>        // For std::countr_zero, std::countl_zero and std::popcount
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+namespace utils {
+
+namespace simd_detail {
+
+inline auto load_u64(const std::byte* data) -> uint64_t {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+//! Index of the first differing byte of two 8-byte words known to differ
+inline auto first_diff_in_word(uint64_t diff) -> size_t {
+    return static_cast<size_t>((std::endian::native == std::endian::little) ? std::countr_zero(diff) / 8
+                                                                            : std::countl_zero(diff) / 8);
+}
+
+} // namespace simd_detail
+
+/**
+ * @brief Finds the first position where two byte ranges of the same length differ.
+ *
+ * Compares 32 bytes per step with AVX2, 16 bytes per step with SSE4.2 and 8 bytes per step otherwise.
+ * The vector paths are selected at compile time (see ENABLE_NATIVE_ARCH in CMakeLists.txt).
+ *
+ * @param lhs Pointer to the first range.
+ * @param rhs Pointer to the second range.
+ * @param size Number of bytes to compare.
+ * @return The index of the first differing byte, or size if the ranges are equal.
+ */
+inline auto mismatch_index(const std::byte* lhs, const std::byte* rhs, size_t size) -> size_t {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= size; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+        const auto diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+        if (diff != 0) {
+            return i + static_cast<size_t>(std::countr_zero(diff));
+        }
+    }
+#endif
+#if defined(__SSE4_2__)
+    for (; i + 16 <= size; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+        const auto diff = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) & 0xFFFFu;
+        if (diff != 0) {
+            return i + static_cast<size_t>(std::countr_zero(diff));
+        }
+    }
+#endif
+    for (; i + 8 <= size; i += 8) {
+        const uint64_t diff = simd_detail::load_u64(lhs + i) ^ simd_detail::load_u64(rhs + i);
+        if (diff != 0) {
+            return i + simd_detail::first_diff_in_word(diff);
+        }
+    }
+    for (; i < size; ++i) {
+        if (lhs[i] != rhs[i]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief Checks two fixed 32-byte keys (hashes, storage slots) for equality.
+ *
+ * A single load/compare/movemask with AVX2, two with SSE4.2, four 8-byte XORs otherwise.
+ */
+inline auto equal_32(const std::byte* lhs, const std::byte* rhs) -> bool {
+#if defined(__AVX2__)
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))) == 0xFFFFFFFFu;
+#elif defined(__SSE4_2__)
+    const __m128i lo = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs)),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs)));
+    const __m128i hi = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + 16)),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + 16)));
+    return _mm_movemask_epi8(_mm_and_si128(lo, hi)) == 0xFFFF;
+#else
+    uint64_t diff = 0;
+    for (size_t i = 0; i < 32; i += 8) {
+        diff |= simd_detail::load_u64(lhs + i) ^ simd_detail::load_u64(rhs + i);
+    }
+    return diff == 0;
+#endif
+}
+
+/**
+ * @brief Checks two byte ranges for equality.
+ */
+inline auto bytes_equal(std::span<const std::byte> lhs, std::span<const std::byte> rhs) -> bool {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    if (lhs.size() == 32) {
+        return equal_32(lhs.data(), rhs.data());
+    }
+    return mismatch_index(lhs.data(), rhs.data(), lhs.size()) == lhs.size();
+}
+
+/**
+ * @brief Checks whether a byte range starts with the provided prefix.
+ *
+ * Meant for the per-record prefix checks of range scans and lookback queries.
+ */
+inline auto starts_with(std::span<const std::byte> data, std::span<const std::byte> prefix) -> bool {
+    if (data.size() < prefix.size()) {
+        return false;
+    }
+    if (prefix.size() == 32) {
+        return equal_32(data.data(), prefix.data());
+    }
+    return mismatch_index(data.data(), prefix.data(), prefix.size()) == prefix.size();
+}
+
+inline auto starts_with(std::span<const std::byte> data, std::string_view prefix) -> bool {
+    return starts_with(data, std::as_bytes(std::span{prefix.data(), prefix.size()}));
+}
+
+/**
+ * @brief Lexicographically compares two byte ranges as unsigned bytes, like memcmp followed by a length compare.
+ */
+inline auto compare_bytes(std::span<const std::byte> lhs, std::span<const std::byte> rhs) -> std::strong_ordering {
+    const size_t common = std::min(lhs.size(), rhs.size());
+    const size_t index = mismatch_index(lhs.data(), rhs.data(), common);
+    if (index < common) {
+        return std::to_integer<uint8_t>(lhs[index]) <=> std::to_integer<uint8_t>(rhs[index]);
+    }
+    return lhs.size() <=> rhs.size();
+}
+
+/**
+ * @brief Counts the elements of an ascending array that are less than or equal to target.
+ *
+ * For sorted input this is the index just past the largest element <= target, i.e. the answer of a
+ * "largest <= target" search. AVX2 compares 4 elements per step (on sign-flipped values, as AVX2 only
+ * has a signed 64-bit compare); the count is branch-free so short arrays are scanned rather than bisected.
+ */
+inline auto count_less_equal(const uint64_t* values, size_t size, uint64_t target) -> size_t {
+    size_t count = 0;
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+    const __m256i bound = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(target)), sign);
+    for (; i + 4 <= size; i += 4) {
+        const __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)), sign);
+        const auto greater = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, bound))));
+        count += 4 - static_cast<size_t>(std::popcount(greater));
+    }
+#endif
+    for (; i < size; ++i) {
+        count += values[i] <= target ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace utils
@@ -1,6 +1,32 @@
+#include "utils/composite_key.hpp"
 #include "utils/endian.hpp"
+#include "utils/history_chunk.hpp"
+#include "utils/key_schema.hpp"
+#include "utils/simd_compare.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include <fmt/core.h>
 
+// Composite keys are encodable at compile time
+static_assert(utils::CompositeKey{"alice", 0x0102}.size() == 5 + 8);
+static_assert(utils::CompositeKey{"alice", 0x0102}.bytes()[11] == std::byte{0x01});
+static_assert(utils::CompositeKey{"alice", 0x0102}.bytes()[12] == std::byte{0x02});
+static_assert(utils::CompositeKey{"", 42}.block_number() == 42);
+static_assert(utils::from_big_endian_bytes(utils::to_big_endian_bytes(0xDEADBEEF)) == 0xDEADBEEF);
+
+// Key schemas: fixed sizes, offsets and round trips at compile time
+static_assert(utils::AccountHistoryKey::kSize == 28);
+static_assert(utils::StorageHistoryKey::kOffset<2> == 52);
+static_assert(utils::KeySchema<utils::BigEndian<uint32_t>, utils::BlockBE64>::get<0>(
+                  utils::KeySchema<utils::BigEndian<uint32_t>, utils::BlockBE64>::encode(0xA0B0C0D0u, 9)) == 0xA0B0C0D0u);
+static_assert(utils::AccountHistoryKey::get<1>(utils::AccountHistoryKey::encode({}, 1234)) == 1234);
+static_assert(utils::AccountHistoryKey::prefix(utils::Address20::value_type{}).size() == 20);
+
 int main() {
     uint64_t block = 5;
     
@@ -22,6 +48,131 @@ int main() {
         uint64_t back = utils::from_big_endian_bytes(bytes);
         fmt::print("Test {}: {} -> {} ({})\n", test_val, test_val, back, test_val == back ? "OK" : "FAIL");
     }
-    
+
+    // In-place big-endian load of a key suffix
+    std::array<std::byte, 12> key{};
+    const auto suffix = utils::to_big_endian_bytes(0x0102030405060708ULL);
+    std::copy(suffix.begin(), suffix.end(), key.begin() + 4);
+    uint64_t loaded = utils::load_big_endian_u64(key.data() + 4);
+    fmt::print("Unaligned load: {:#x} ({})\n", loaded, loaded == 0x0102030405060708ULL ? "OK" : "FAIL");
+    assert(loaded == 0x0102030405060708ULL);
+
+    // SIMD compare/prefix helpers against memcmp for every length and mismatch position
+    std::array<std::byte, 80> lhs{};
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        lhs[i] = static_cast<std::byte>(i * 7 + 1);
+    }
+    for (size_t size = 0; size <= lhs.size(); ++size) {
+        for (size_t pos = 0; pos <= size; ++pos) {
+            auto rhs = lhs;
+            if (pos < size) {
+                rhs[pos] = static_cast<std::byte>(0xFF);
+            }
+            const std::span<const std::byte> a{lhs.data(), size};
+            const std::span<const std::byte> b{rhs.data(), size};
+            assert(utils::mismatch_index(a.data(), b.data(), size) == pos);
+            assert(utils::bytes_equal(a, b) == (pos == size));
+            assert(utils::starts_with(std::span<const std::byte>{lhs}, b) == (pos == size));
+            const int expected = std::memcmp(a.data(), b.data(), size);
+            const auto ordering = utils::compare_bytes(a, b);
+            assert((expected < 0) == (ordering < 0) && (expected == 0) == (ordering == 0));
+        }
+    }
+    assert(utils::equal_32(lhs.data(), lhs.data()));
+    assert(!utils::equal_32(lhs.data(), lhs.data() + 1));
+    assert(!utils::starts_with(std::span<const std::byte>{lhs.data(), 4}, std::span<const std::byte>{lhs.data(), 5}));
+    assert(utils::compare_bytes(std::span<const std::byte>{lhs.data(), 4}, std::span<const std::byte>{lhs.data(), 5}) < 0);
+    fmt::print("SIMD compare: OK\n");
+
+    // Stack composite key matches the former vector encoding and orders by block within an account
+    utils::CompositeKey composite{"account_0001", 7};
+    assert(composite.account_size() == 12 && composite.block_number() == 7);
+    assert(utils::starts_with(composite.bytes(), std::string_view{"account_0001"}));
+    const auto be_seven = utils::to_big_endian_bytes(7);
+    assert(std::equal(be_seven.begin(), be_seven.end(), composite.data() + 12));
+    const utils::CompositeKey later{"account_0001", 256};
+    assert(utils::compare_bytes(composite, later) < 0);
+    composite.set_block_number(256);
+    assert(utils::bytes_equal(composite, later));
+
+    bool thrown = false;
+    try {
+        utils::CompositeKey too_long{std::string(utils::kMaxAccountNameLength + 1, 'x'), 0};
+    } catch (const std::length_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    fmt::print("Composite key: OK\n");
+
+    // Key schema: encoding order matches value order, prefixes and successors bound prefix scans
+    using Schema = utils::AccountHistoryKey;
+    utils::Address20::value_type address{};
+    address[0] = std::byte{0x80};
+    address[19] = std::byte{0xFF};
+    const auto low = Schema::encode(address, 255);
+    const auto high = Schema::encode(address, 256);
+    assert(utils::compare_bytes(low, high) < 0);
+    const auto [decoded_address, decoded_block] = Schema::decode(high);
+    assert(decoded_address == address && decoded_block == 256);
+
+    auto upper = Schema::prefix(address);
+    assert(utils::starts_with(low, upper) && utils::starts_with(high, upper));
+    assert(Schema::successor(upper));
+    assert(upper[19] == std::byte{0x00} && upper[18] == std::byte{0x01});
+    assert(utils::compare_bytes(high, upper) < 0);
+    std::array<std::byte, 2> saturated{std::byte{0xFF}, std::byte{0xFF}};
+    assert(!Schema::successor(saturated));
+    fmt::print("Key schema: OK\n");
+
+    // History chunk: delta+varint round trip and "largest <= target" search
+    std::vector<std::string> states;
+    std::vector<utils::HistoryEntry> versions;
+    for (uint64_t i = 0; i < utils::kMaxHistoryChunkEntries; ++i) {
+        states.push_back("state_" + std::to_string(i));
+    }
+    for (uint64_t i = 0; i < utils::kMaxHistoryChunkEntries; ++i) {
+        const uint64_t block = 1000 + i * i * 37;  // Growing gaps: 1 to 3 varint bytes per delta
+        versions.push_back({block, std::as_bytes(std::span{states[i].data(), states[i].size()})});
+    }
+    const auto encoded = utils::encode_history_chunk(versions);
+    const utils::HistoryChunkView view{encoded};
+    assert(view.size() == versions.size() && view.first_block() == 1000);
+    size_t raw_bytes = 0;
+    for (size_t i = 0; i < versions.size(); ++i) {
+        assert(view.block_number(i) == versions[i].block_number);
+        assert(utils::bytes_equal(view.entry(i).value, versions[i].value));
+        raw_bytes += sizeof(uint64_t) + versions[i].value.size();
+    }
+    for (uint64_t target : {uint64_t{0}, uint64_t{999}, uint64_t{1000}, uint64_t{1036}, uint64_t{1037},
+                            uint64_t{50000}, UINT64_MAX}) {
+        const auto found = view.find_less_equal(target);
+        const auto it = std::upper_bound(versions.begin(), versions.end(), target,
+                                         [](uint64_t t, const utils::HistoryEntry& e) { return t < e.block_number; });
+        assert(found.has_value() == (it != versions.begin()));
+        if (found) {
+            assert(found->block_number == std::prev(it)->block_number);
+        }
+    }
+    assert(view.last().block_number == versions.back().block_number);
+    fmt::print("History chunk: {} versions in {} bytes ({} bytes with 8-byte block numbers)\n", versions.size(),
+               encoded.size(), raw_bytes);
+    assert(encoded.size() < raw_bytes);
+
+    auto rewritten = view.entries();
+    const std::string replaced = "replaced";
+    utils::upsert_history_entry(rewritten, {1000, std::as_bytes(std::span{replaced.data(), replaced.size()})});
+    utils::upsert_history_entry(rewritten, {1001, std::as_bytes(std::span{replaced.data(), replaced.size()})});
+    assert(rewritten.size() == versions.size() + 1 && rewritten[1].block_number == 1001);
+    assert(utils::bytes_equal(rewritten[0].value, rewritten[1].value));
+
+    thrown = false;
+    try {
+        const utils::HistoryChunkView truncated{std::span{encoded}.first(encoded.size() - 1)};
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    fmt::print("History chunk: OK\n");
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,508 @@
+#include "core/query_engine.hpp"
+#include "db/mdbx_impl.hpp"
+#include "db/value_codec.hpp"
+#include "utils/composite_key.hpp"
+
+#include <fmt/format.h>
+#include <mdbx.h++>
+#include <cassert>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+auto fresh_db_path(std::string_view name) -> std::filesystem::path {
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(path);
+    return path;
+}
+
+auto as_bytes(std::string_view text) -> std::span<const std::byte> {
+    return std::as_bytes(std::span{text.data(), text.size()});
+}
+
+auto as_string(const std::optional<std::vector<std::byte>>& state) -> std::string {
+    assert(state);
+    return {reinterpret_cast<const char*>(state->data()), state->size()};
+}
+
+auto as_text(std::span<const std::byte> bytes) -> std::string {
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+// Account state shaped like the benchmark data: small JSON values that compress well with a dictionary
+auto sample_state(uint64_t block) -> std::string {
+    return fmt::format(R"({{"balance": "{}", "nonce": "{}", "block": "{}"}})", block * 1000, block % 256, block);
+}
+
+#if HAVE_ZSTD
+// Reads a value as stored in the table, bypassing MdbxImpl and its codec
+auto read_stored(const std::filesystem::path& db_path, const char* map_name, std::span<const std::byte> key)
+    -> std::vector<std::byte> {
+    mdbx::env_managed::operate_parameters operate_params;
+    operate_params.max_maps = 16;
+    mdbx::env_managed env{db_path.string(), operate_params};
+    auto txn = env.start_read();
+    const auto stored = txn.get(txn.open_map(map_name), mdbx::slice{key.data(), key.size()}, mdbx::slice{});
+    const auto bytes = std::as_bytes(std::span{stored.char_ptr(), stored.length()});
+    return {bytes.begin(), bytes.end()};
+}
+#endif
+
+// Writes the same versions to both layouts, one batch per call
+void write_versions(MdbxImpl& per_key, MdbxImpl& chunks, const std::vector<std::pair<std::string, uint64_t>>& versions,
+                    std::string_view tag = "") {
+    WriteBatch per_key_batch;
+    WriteBatch chunks_batch;
+    for (const auto& [account, block] : versions) {
+        const utils::CompositeKey key{account, block};
+        const auto value = fmt::format("{}@{}{}", account, block, tag);
+        per_key_batch.put(key.bytes(), as_bytes(value));
+        chunks_batch.put(key.bytes(), as_bytes(value));
+    }
+    per_key.write(std::move(per_key_batch), Durability::kNoSync);
+    chunks.write(std::move(chunks_batch), Durability::kNoSync);
+}
+
+} // namespace
+
+void test_write_batch() {
+    fmt::println("\n=== 测试 MdbxImpl::write 原子写入 ===");
+    const auto db_path = fresh_db_path("mdbx_impl_write_test");
+
+    for (const auto layout : {MdbxLayout::kVersionPerKey, MdbxLayout::kHistoryChunks}) {
+        MdbxImpl db{db_path, layout};
+
+        // 批次中任何一条写入失败时，整个批次都不可见
+        WriteBatch failing;
+        const utils::CompositeKey alice{"alice", 10};
+        const utils::CompositeKey bob{"bob", 10};
+        failing.put(alice.bytes(), as_bytes("alice@10"));
+        failing.put(bob.bytes(), as_bytes("bob@10"));
+        const std::string oversized_key(100'000, '\xff');  // 超过MDBX最大键长，且排序在最后
+        failing.put(as_bytes(oversized_key), as_bytes("too long"));
+        bool thrown = false;
+        try {
+            db.write(std::move(failing), Durability::kSync);
+        } catch (const std::exception&) {
+            thrown = true;
+        }
+        assert(thrown);
+        auto state = db.get_state("alice", 10);
+        assert(!state);
+        state = db.get_state("bob", 10);
+        assert(!state);
+
+        // 成功的批次一次性可见
+        WriteBatch batch;
+        batch.put(bob.bytes(), as_bytes("bob@10"));
+        batch.put(alice.bytes(), as_bytes("alice@10"));
+        db.write(std::move(batch), Durability::kSync);
+        assert(as_string(db.get_state("alice", 15)) == "alice@10");
+        assert(as_string(db.get_state("bob", 10)) == "bob@10");
+
+        // 空批次不做任何事
+        db.write(WriteBatch{}, Durability::kSync);
+    }
+    std::filesystem::remove_all(db_path);
+
+    fmt::println("✓ MdbxImpl::write 原子写入测试通过");
+}
+
+void test_import_block_no_sync() {
+    fmt::println("\n=== 测试 import_block (kNoSync) ===");
+    const auto db_path = fresh_db_path("mdbx_impl_import_test");
+
+    {
+        QueryEngine engine{std::make_unique<MdbxImpl>(db_path)};
+        engine.set_account_state("alice", 1, "alice@1");
+        const AccountStateChange block_20[] = {
+            {"alice", "alice@20"},
+            {"bob", "bob@20"},
+        };
+        engine.import_block(20, block_20, Durability::kNoSync);
+
+        // 不刷盘的事务提交后立即对读可见
+        auto result = engine.find_account_state("alice", 25);
+        assert(result && *result == "alice@20");
+        result = engine.find_account_state("alice", 19);
+        assert(result && *result == "alice@1");
+        result = engine.find_account_state("bob", 20);
+        assert(result && *result == "bob@20");
+        result = engine.find_account_state("bob", 19);
+        assert(!result);
+    }
+
+    // 关闭环境时刷盘，重新打开后数据仍在
+    {
+        QueryEngine engine{std::make_unique<MdbxImpl>(db_path)};
+        auto result = engine.find_account_state("bob", 30);
+        assert(result && *result == "bob@20");
+    }
+    std::filesystem::remove_all(db_path);
+
+    fmt::println("✓ import_block (kNoSync) 测试通过");
+}
+
+void test_history_chunks() {
+    fmt::println("\n=== 测试历史分块布局 (与逐版本布局对比) ===");
+    const auto per_key_path = fresh_db_path("mdbx_impl_per_key_test");
+    const auto chunks_path = fresh_db_path("mdbx_impl_chunks_test");
+
+    {
+        MdbxImpl per_key{per_key_path, MdbxLayout::kVersionPerKey};
+        MdbxImpl chunks{chunks_path, MdbxLayout::kHistoryChunks};
+
+        // 顺序追加 200 个版本：开放分块超过 64 条后被多次拆分
+        std::vector<std::pair<std::string, uint64_t>> versions;
+        for (uint64_t block = 10; block <= 2000; block += 10) {
+            versions.emplace_back("alice", block);
+        }
+        // "ali" 是 "alice" 的前缀，"alicf" 紧随其后：长度前缀保证各账户的分块互不混淆
+        for (uint64_t block = 5; block <= 2000; block += 150) {
+            versions.emplace_back("ali", block);
+            versions.emplace_back("alicf", block + 1);
+        }
+        write_versions(per_key, chunks, versions);
+
+        // 乱序插入已关闭的分块，其中一个分块再次被填满并拆分
+        versions.clear();
+        for (uint64_t block = 11; block < 650; block += 10) {
+            versions.emplace_back("alice", block);
+        }
+        versions.emplace_back("alice", 1);     // 早于所有已有版本
+        versions.emplace_back("alice", 1005);  // 落在中间的分块
+        write_versions(per_key, chunks, versions);
+
+        // 覆盖已有版本，以及单条写入
+        write_versions(per_key, chunks, {{"alice", 640}, {"ali", 155}}, "'");
+        const utils::CompositeKey late{"alice", 2500};
+        per_key.put(late.bytes(), as_bytes("alice@2500"));
+        chunks.put(late.bytes(), as_bytes("alice@2500"));
+
+        // 逐块比较两种布局的查询结果，覆盖分块边界（包括回退到前一个分块的情况）
+        size_t found = 0;
+        for (const std::string account : {"al", "ali", "alice", "alicf", "alicee", "bob"}) {
+            for (uint64_t block = 0; block <= 2600; ++block) {
+                const auto expected = per_key.get_state(account, block);
+                const auto actual = chunks.get_state(account, block);
+                if (expected != actual) {
+                    fmt::println("❌ {}@{}: 逐版本={}, 分块={}", account, block,
+                                 expected ? as_string(expected) : "无", actual ? as_string(actual) : "无");
+                }
+                assert(expected == actual);
+                found += expected ? 1 : 0;
+            }
+        }
+        fmt::println("比较 {} 次查询, 其中 {} 次有结果", 6 * 2601, found);
+
+        // 抽查几个已知答案，确认对照组本身正确
+        const auto before_first = chunks.get_state("alice", 0);
+        assert(!before_first);
+        assert(as_string(chunks.get_state("alice", 1)) == "alice@1");
+        assert(as_string(chunks.get_state("alice", 651)) == "alice@650");
+        assert(as_string(chunks.get_state("alice", 640)) == "alice@640'");
+        assert(as_string(chunks.get_state("alice", 645)) == "alice@641");
+        assert(as_string(chunks.get_state("alice", 1007)) == "alice@1005");
+        assert(as_string(chunks.get_state("ali", 160)) == "ali@155'");
+        assert(as_string(chunks.get_state("alicf", 2600)) == "alicf@1956");
+        assert(as_string(chunks.get_state("alice", 99999)) == "alice@2500");
+    }
+    std::filesystem::remove_all(per_key_path);
+    std::filesystem::remove_all(chunks_path);
+
+    fmt::println("✓ 历史分块布局测试通过");
+}
+
+void test_value_codec() {
+    fmt::println("\n=== 测试 ValueCodec 编解码与头字节 ===");
+    const std::string small = "tiny";
+    const std::string repetitive = sample_state(42) + sample_state(42) + sample_state(42);
+    std::string random_bytes(256, '\0');
+    std::mt19937 gen{7};
+    for (auto& c : random_bytes) {
+        c = static_cast<char>(gen());
+    }
+
+    // 不压缩：只加一个 kRaw 头字节
+    {
+        ValueCodec codec{ValueCodecOptions{}};
+        const auto stored = codec.encode(as_bytes(repetitive));
+        assert(ValueCodec::format_of(stored) == ValueCodec::Format::kRaw);
+        assert(stored.size() == 1 + repetitive.size());
+        assert(as_text(codec.decode(stored)) == repetitive);
+    }
+
+    // 空值没有头字节，视为损坏
+    bool thrown = false;
+    try {
+        (void)ValueCodec::format_of({});
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+#if HAVE_LZ4
+    {
+        ValueCodec codec{ValueCodecOptions{.compression = ValueCompression::kLz4}};
+        const auto stored = codec.encode(as_bytes(repetitive));
+        assert(ValueCodec::format_of(stored) == ValueCodec::Format::kLz4);
+        assert(stored.size() < repetitive.size());
+        assert(as_text(codec.decode(stored)) == repetitive);
+
+        // 小于 min_compress_size 或压缩后不变小的值保持原样
+        const auto stored_small = codec.encode(as_bytes(small));
+        assert(ValueCodec::format_of(stored_small) == ValueCodec::Format::kRaw);
+        assert(as_text(codec.decode(stored_small)) == small);
+        const auto stored_random = codec.encode(as_bytes(random_bytes));
+        assert(ValueCodec::format_of(stored_random) == ValueCodec::Format::kRaw);
+        assert(as_text(codec.decode(stored_random)) == random_bytes);
+    }
+#else
+    thrown = false;
+    try {
+        ValueCodec codec{ValueCodecOptions{.compression = ValueCompression::kLz4}};
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+#endif
+
+#if HAVE_ZSTD
+    {
+        // 不训练字典：普通 zstd 帧
+        ValueCodec codec{ValueCodecOptions{.compression = ValueCompression::kZstd, .dictionary_sample_count = 0}};
+        const auto stored = codec.encode(as_bytes(repetitive));
+        assert(ValueCodec::format_of(stored) == ValueCodec::Format::kZstd);
+        assert(stored.size() < repetitive.size());
+        assert(as_text(codec.decode(stored)) == repetitive);
+        const auto stored_small = codec.encode(as_bytes(small));
+        assert(ValueCodec::format_of(stored_small) == ValueCodec::Format::kRaw);
+        assert(codec.dictionary().empty());
+    }
+    {
+        // 采样期间的小值单独压缩得不偿失而保持原样，训练出字典后改用字典压缩
+        const ValueCodecOptions options{.compression = ValueCompression::kZstd,
+                                        .dictionary_sample_count = 256,
+                                        .dictionary_size = 4096};
+        ValueCodec codec{options};
+        std::vector<std::vector<std::byte>> stored;
+        for (uint64_t block = 0; block < 512; ++block) {
+            stored.push_back(codec.encode(as_bytes(sample_state(block))));
+        }
+        assert(!codec.dictionary().empty());
+        assert(ValueCodec::format_of(stored.front()) == ValueCodec::Format::kRaw);
+        assert(ValueCodec::format_of(stored.back()) == ValueCodec::Format::kZstdDict);
+        assert(stored.back().size() < sample_state(511).size());
+        for (uint64_t block = 0; block < 512; ++block) {
+            assert(as_text(codec.decode(stored[block])) == sample_state(block));
+        }
+
+        // 字典压缩的值需要先加载同一个字典才能解码
+        ValueCodec reopened{options};
+        thrown = false;
+        try {
+            (void)reopened.decode(stored.back());
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        reopened.load_dictionary(codec.dictionary());
+        assert(as_text(reopened.decode(stored.back())) == sample_state(511));
+
+        // 字典只能设置一次
+        thrown = false;
+        try {
+            reopened.load_dictionary(codec.dictionary());
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+#else
+    thrown = false;
+    try {
+        ValueCodec codec{ValueCodecOptions{.compression = ValueCompression::kZstd}};
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+#endif
+
+    fmt::println("✓ ValueCodec 编解码测试通过");
+}
+
+void test_dictionary_persistence() {
+#if HAVE_ZSTD
+    fmt::println("\n=== 测试 zstd 字典持久化 (ValueDictionary) ===");
+    const auto db_path = fresh_db_path("mdbx_impl_dictionary_test");
+    const MdbxOptions options{
+        .values = {.compression = ValueCompression::kZstd, .dictionary_sample_count = 256, .dictionary_size = 4096},
+        .hot_cache_entries = 64,
+    };
+
+    {
+        MdbxImpl db{db_path, options};
+        for (uint64_t block = 0; block < 512; ++block) {
+            const utils::CompositeKey key{"alice", block};
+            db.put(key.bytes(), as_bytes(sample_state(block)));
+        }
+    }
+
+    // 字典与用它压缩的值存在同一个环境中
+    const utils::CompositeKey last{"alice", 511};
+    const auto stored = read_stored(db_path, "AccountState.z", last.bytes());
+    assert(ValueCodec::format_of(stored) == ValueCodec::Format::kZstdDict);
+    const auto dictionary = read_stored(db_path, "ValueDictionary", as_bytes("AccountState.z"));
+    assert(!dictionary.empty());
+
+    // 重新打开后从 ValueDictionary 加载字典，旧值仍可解码，新值继续使用同一个字典
+    {
+        MdbxImpl db{db_path, options};
+        for (uint64_t block = 0; block < 512; ++block) {
+            assert(as_string(db.get_state("alice", block)) == sample_state(block));
+        }
+        const utils::CompositeKey key{"bob", 1};
+        db.put(key.bytes(), as_bytes(sample_state(1)));
+        assert(as_string(db.get_state("bob", 1)) == sample_state(1));
+    }
+    assert(read_stored(db_path, "ValueDictionary", as_bytes("AccountState.z")) == dictionary);
+    const utils::CompositeKey bob{"bob", 1};
+    assert(ValueCodec::format_of(read_stored(db_path, "AccountState.z", bob.bytes())) ==
+           ValueCodec::Format::kZstdDict);
+    std::filesystem::remove_all(db_path);
+
+    fmt::println("✓ zstd 字典持久化测试通过");
+#else
+    // 未编译 zstd 时，请求 zstd 压缩在构造时失败
+    bool thrown = false;
+    try {
+        MdbxImpl db{fresh_db_path("mdbx_impl_dictionary_test"),
+                    MdbxOptions{.values = {.compression = ValueCompression::kZstd}}};
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+    fmt::println("\n⚠ 未启用 ENABLE_ZSTD，跳过 zstd 字典持久化测试");
+#endif
+}
+
+void test_hot_value_cache() {
+    fmt::println("\n=== 测试 HotValueCache 命中、未命中与淘汰 ===");
+    const auto value = [](std::string_view text) {
+        const auto bytes = as_bytes(text);
+        return std::make_shared<const std::vector<std::byte>>(bytes.begin(), bytes.end());
+    };
+
+    HotValueCache cache{2};
+    assert(cache.find(as_bytes("a"), as_bytes("stored-a")) == nullptr);
+    cache.insert(as_bytes("a"), as_bytes("stored-a"), value("value-a"));
+    auto hit = cache.find(as_bytes("a"), as_bytes("stored-a"));
+    assert(hit && as_text(*hit) == "value-a");
+
+    // 存储字节不同（另一个快照中的值）不命中
+    assert(cache.find(as_bytes("a"), as_bytes("stored-a2")) == nullptr);
+
+    // 容量为 2：访问 a 后插入 c，淘汰最久未用的 b
+    cache.insert(as_bytes("b"), as_bytes("stored-b"), value("value-b"));
+    hit = cache.find(as_bytes("a"), as_bytes("stored-a"));
+    assert(hit);
+    cache.insert(as_bytes("c"), as_bytes("stored-c"), value("value-c"));
+    assert(cache.find(as_bytes("b"), as_bytes("stored-b")) == nullptr);
+    hit = cache.find(as_bytes("a"), as_bytes("stored-a"));
+    assert(hit && as_text(*hit) == "value-a");
+    hit = cache.find(as_bytes("c"), as_bytes("stored-c"));
+    assert(hit && as_text(*hit) == "value-c");
+
+    // 重新插入已有的键会替换存储字节和值
+    cache.insert(as_bytes("a"), as_bytes("stored-a2"), value("value-a2"));
+    hit = cache.find(as_bytes("a"), as_bytes("stored-a2"));
+    assert(hit && as_text(*hit) == "value-a2");
+    assert(cache.find(as_bytes("a"), as_bytes("stored-a")) == nullptr);
+
+    assert(cache.hits() == 5);
+    assert(cache.misses() == 4);
+
+    // 容量为 0 时不缓存任何值
+    HotValueCache disabled{0};
+    disabled.insert(as_bytes("a"), as_bytes("stored-a"), value("value-a"));
+    assert(disabled.find(as_bytes("a"), as_bytes("stored-a")) == nullptr);
+
+    fmt::println("✓ HotValueCache 测试通过");
+}
+
+void test_long_account_names() {
+    fmt::println("\n=== 测试超长账户名 ===");
+    const auto db_path = fresh_db_path("mdbx_impl_long_name_test");
+    const std::string long_name(utils::kMaxAccountNameLength + 1, 'a');
+
+    for (const auto layout : {MdbxLayout::kVersionPerKey, MdbxLayout::kHistoryChunks}) {
+        auto owned = std::make_unique<MdbxImpl>(db_path, layout);
+        MdbxImpl& db = *owned;
+        QueryEngine engine{std::move(owned)};
+
+        // 读路径：这样的键不可能存在，返回"未找到"而不是抛异常
+        auto result = engine.find_account_state(long_name, 10);
+        assert(!result);
+
+        // 写路径拒绝超长账户名
+        bool thrown = false;
+        try {
+            engine.set_account_state(long_name, 10, "state");
+        } catch (const std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        // 绕过 QueryEngine 直接写入原始键同样被拒绝，批次中的其他写入也不可见
+        const std::string raw_key = long_name + std::string(sizeof(uint64_t), '\0');
+        const utils::CompositeKey bob{"bob", 10};
+        WriteBatch batch;
+        batch.put(bob.bytes(), as_bytes("bob@10"));
+        batch.put(as_bytes(raw_key), as_bytes("state"));
+        thrown = false;
+        try {
+            db.write(std::move(batch), Durability::kSync);
+        } catch (const std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        result = engine.find_account_state("bob", 10);
+        assert(!result);
+
+        // 恰好 128 字节的账户名可以写入和查询
+        const std::string longest_name(utils::kMaxAccountNameLength, 'b');
+        engine.set_account_state(longest_name, 10, "longest@10");
+        result = engine.find_account_state(longest_name, 20);
+        assert(result && *result == "longest@10");
+    }
+    std::filesystem::remove_all(db_path);
+
+    fmt::println("✓ 超长账户名测试通过");
+}
+
+int main() {
+    fmt::println("开始 MdbxImpl 测试");
+
+    try {
+        test_write_batch();
+        test_import_block_no_sync();
+        test_history_chunks();
+        test_value_codec();
+        test_dictionary_persistence();
+        test_hot_value_cache();
+        test_long_account_names();
+
+        fmt::println("\n🎉 所有 MdbxImpl 测试通过！");
+    } catch (const std::exception& e) {
+        fmt::println("❌ 测试失败: {}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
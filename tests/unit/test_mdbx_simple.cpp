@@ -1,10 +1,20 @@
 #include "db/mdbx.hpp"
+#include "db/mdbx_fast_cursor.hpp"
+#include "db/mdbx_heatmap.hpp"
+#include "db/mdbx_pruner.hpp"
+#include "db/mdbx_warmer.hpp"
+#include "utils/key_schema.hpp"
+#include "utils/metrics.hpp"
 #include "../src/utils/string_utils.hpp"
 #include <fmt/format.h>
 #include <string>
 #include <vector>
 #include <cassert>
 #include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <thread>
 
 using namespace datastore::kvdb;
 using namespace utils;
@@ -718,6 +728,728 @@ void test_important_features(::mdbx::env_managed& env) {
     fmt::println("✓ 重要功能测试通过");
 }
 
+void test_find_batch(::mdbx::env_managed& env) {
+    fmt::println("\n=== 测试批量查找 find_batch ===");
+
+    MapConfig config{"find_batch_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+
+    // 准备测试数据：偶数下标的键存在，奇数下标的键不存在
+    {
+        RWTxnManaged txn(env);
+        auto cursor = txn.rw_cursor(config);
+        for (size_t i = 0; i < 1000; i += 2) {
+            std::string key = uint64_to_hex(i);
+            std::string value = "value_" + key;
+            cursor->upsert(str_to_slice(key), str_to_slice(value));
+        }
+        txn.commit_and_stop();
+    }
+
+    // 乱序的查询键
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 1000; ++i) {
+        keys.push_back(uint64_to_hex((i * 7919) % 1000));
+    }
+    std::vector<ByteView> key_views;
+    for (const auto& key : keys) {
+        key_views.push_back(str_to_byteview(key));
+    }
+
+    for (size_t threads : {0, 1, 4}) {
+        ROTxnManaged ro_txn(env);
+        std::vector<int> seen(keys.size(), 0);
+        BatchFindOptions options{.prefetch_distance = 16, .prefetch_threads = threads};
+        size_t found = find_batch(ro_txn, config, key_views, [&](size_t index, const CursorResult& result) {
+            ++seen[index];
+            const bool should_exist = hex_to_uint64(keys[index]) % 2 == 0;
+            assert_cursor_result(result, should_exist);
+            if (should_exist) {
+                assert(result.value.as_string() == "value_" + keys[index]);
+            }
+        }, options);
+        fmt::println("预取线程数 {}: 找到 {} 个键", threads, found);
+        assert(found == 500);
+        assert(std::all_of(seen.begin(), seen.end(), [](int n) { return n == 1; }));
+        ro_txn.abort();
+    }
+
+    fmt::println("✓ 批量查找测试通过");
+}
+
+void test_page_warmer(::mdbx::env_managed& env, const EnvConfig& env_config) {
+    fmt::println("\n=== 测试页面预热 PageWarmer ===");
+
+    // 测试 key_midpoint：结果位于两个键之间
+    auto to_bytes = [](const std::string& s) {
+        std::vector<std::byte> bytes(s.size());
+        std::memcpy(bytes.data(), s.data(), s.size());
+        return bytes;
+    };
+    for (const auto& [lo, hi] : std::vector<std::pair<std::string, std::string>>{
+             {"0000", "ffff"}, {"a", "b"}, {"abc", "abd"}, {"x", "x\x01"}}) {
+        auto lo_bytes = to_bytes(lo);
+        auto hi_bytes = to_bytes(hi);
+        auto mid = detail::key_midpoint(lo_bytes, hi_bytes);
+        assert(!std::ranges::lexicographical_compare(mid, lo_bytes));
+        assert(std::ranges::lexicographical_compare(mid, hi_bytes));
+    }
+    fmt::println("key_midpoint 测试通过");
+
+    // 未启用预热时不创建预热器
+    EnvConfig config = env_config;
+    config.warmup = false;
+    assert(start_page_warmer(env, config, {}) == nullptr);
+
+    // 对已有表执行完整预热（不限速）
+    MapConfig table_config{"find_batch_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+    MapConfig missing_config{"warmer_missing_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+    config.warmup = true;
+    config.warmup_bandwidth = 0;
+    config.warmup_tree_samples = 100;
+    config.warmup_queue_depth = 4;
+    PageWarmer warmer{env, config, {table_config, missing_config}};
+    warmer.add_hot_ranges({{0, 64_Kibi}, {1_Gibi, 4_Kibi}});
+    warmer.start();
+    warmer.wait();
+
+    auto progress = warmer.progress();
+    fmt::println("预热完成: 树下降 {} 次, 热区 {}/{} 字节",
+                 progress.tree_descents, progress.hot_bytes_done, progress.hot_bytes_total);
+    assert(progress.phase == WarmupPhase::kDone);
+    assert(!progress.stopped && !progress.failed);
+    assert(progress.tree_descents > 2 && progress.tree_descents <= 102);
+    assert(progress.hot_bytes_done == progress.hot_bytes_total);
+    assert(progress.hot_bytes_total <= 64_Kibi);  // 超出文件大小的范围被截断
+
+    fmt::println("✓ 页面预热测试通过");
+}
+
+void test_access_heatmap(::mdbx::env_managed& env, const EnvConfig& env_config) {
+    fmt::println("\n=== 测试访问热力图 AccessHeatmap ===");
+
+    // 测试计数、排序、衰减和持久化
+    AccessHeatmap heatmap{4_Kibi};
+    heatmap.record(0);
+    heatmap.record(100, 3);      // 与偏移0同一区段
+    heatmap.record(8_Kibi, 10);
+    heatmap.record(64_Kibi);
+    assert(heatmap.size() == 3);
+    assert(heatmap.hits(4095) == 4);
+    auto ranges = heatmap.hot_ranges();
+    assert(ranges.size() == 3);
+    assert(ranges[0].offset == 8_Kibi && ranges[0].length == 4_Kibi);
+    assert(ranges[1].offset == 0);
+
+    auto heatmap_file = std::filesystem::path{env_config.path} / "test.heat";
+    heatmap.save(heatmap_file);
+    auto loaded = AccessHeatmap::load(heatmap_file);
+    assert(loaded && loaded->extent_size() == 4_Kibi && loaded->size() == 3);
+    assert(loaded->hits(8_Kibi) == 10);
+    loaded->decay();
+    assert(loaded->size() == 2);  // 只被访问一次的区段被淘汰
+    assert(loaded->hits(0) == 2);
+    assert(!AccessHeatmap::load(heatmap_file.string() + ".missing"));
+    std::filesystem::remove(heatmap_file);
+    fmt::println("AccessHeatmap 测试通过");
+
+    // 测试 HeatmapRecorder：每次读都采样
+    EnvConfig config = env_config;
+    config.heatmap = false;
+    assert(start_heatmap_recorder(config) == nullptr);
+    config.heatmap = true;
+    config.heatmap_sample_rate = 1;
+    config.heatmap_extent_size = 4_Kibi;
+    std::filesystem::remove(get_heatmap_path(config.path));
+
+    MapConfig table_config{"find_batch_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+    {
+        auto recorder = start_heatmap_recorder(config);
+        assert(recorder);
+        ROTxnManaged txn(env);
+        PooledCursor cursor(txn, table_config);
+        for (size_t i = 0; i < 1000; i += 2) {
+            std::string key = uint64_to_hex(i);
+            auto result = cursor.find(str_to_slice(key), false);
+            assert(result.done);
+        }
+        txn.abort();
+        fmt::println("采样 {} 次, 热点区段 {} 个", recorder->samples(), recorder->snapshot().size());
+        assert(recorder->samples() == 500);
+        assert(recorder->snapshot().size() > 0);
+    }
+
+    // 析构时保存，预热器可以读取
+    auto saved = AccessHeatmap::load(get_heatmap_path(config.path));
+    assert(saved && saved->size() > 0);
+    config.warmup = true;
+    config.warmup_bandwidth = 0;
+    auto warmer = start_page_warmer(env, config, {table_config});
+    warmer->wait();
+    assert(warmer->progress().hot_bytes_total > 0);
+    std::filesystem::remove(get_heatmap_path(config.path));
+
+    fmt::println("✓ 访问热力图测试通过");
+}
+
+// 回收失败测试用的对象池参数：记录销毁次数，负数无法回收
+struct CountingIntDeleter {
+    static inline int deleted{0};
+    void operator()(int* obj) const noexcept {
+        ++deleted;
+        delete obj;
+    }
+};
+
+struct NonNegativeIntRecycler {
+    bool operator()(int* obj) const noexcept { return *obj >= 0; }
+};
+
+void test_cursor_handle_pool(::mdbx::env_managed& env) {
+    fmt::println("\n=== 测试游标句柄池 ===");
+
+    MapConfig config{"find_batch_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+
+    // 同一线程内重复创建游标应复用本地空闲句柄
+    {
+        ROTxnManaged txn(env);
+        { PooledCursor warm_up(txn, config); }
+        const auto before = PooledCursor::handles_stats();
+        for (int i = 0; i < 100; ++i) {
+            PooledCursor cursor(txn, config);
+            auto result = cursor.find(str_to_slice(uint64_to_hex(0)), false);
+            assert(result.done);
+        }
+        const auto& after = PooledCursor::handles_stats();
+        assert(after.acquired - before.acquired == 100);
+        assert(after.local_hits - before.local_hits == 100);
+        fmt::println("本地复用率: {:.2f}", after.reuse_rate());
+    }
+
+    // 超出本地容量的句柄进入共享空闲表，并被其他线程复用
+    std::thread producer([&env, &config] {
+        ROTxnManaged txn(env);
+        std::vector<PooledCursor> cursors;
+        for (int i = 0; i < 80; ++i) {
+            cursors.emplace_back(txn, config);
+        }
+        cursors.clear();  // 64个留在本地，16个进入共享空闲表
+        assert(PooledCursor::handles_stats().shared_returns == 16);
+        txn.abort();
+    });  // 线程退出时本地句柄也交给共享空闲表
+    producer.join();
+    assert(PooledCursor::HandlesPool::shared_size() >= 80);
+
+    std::thread consumer([&env, &config] {
+        ROTxnManaged txn(env);
+        PooledCursor cursor(txn, config);
+        auto result = cursor.find(str_to_slice(uint64_to_hex(2)), false);
+        assert(result.done);
+        assert(PooledCursor::handles_stats().shared_hits == 1);
+        txn.abort();
+    });
+    consumer.join();
+
+    // 在其他线程释放的句柄进入共享空闲表，而不是释放线程的本地空闲表
+    {
+        ROTxnManaged txn(env);
+        PooledCursor cursor(txn, config);
+        txn.abort();
+        std::thread releaser([cursor = std::move(cursor)]() mutable {
+            { PooledCursor released = std::move(cursor); }
+            const auto& stats = PooledCursor::handles_stats();
+            assert(stats.foreign_returns == 1);
+            assert(stats.shared_returns == 1);
+            assert(PooledCursor::handles_cache().size() == 0);
+        });
+        releaser.join();
+    }
+
+    // 回收失败（如 mdbx_cursor_unbind 出错）的对象被销毁，不进入共享空闲表
+    {
+        using IntPool = ObjectPool<int, CountingIntDeleter, NonNegativeIntRecycler, 1, 4>;
+        IntPool pool;
+        pool.add(new int{1}, &pool);   // 留在本地
+        pool.add(new int{2}, &pool);   // 本地已满，进入共享空闲表
+        pool.add(new int{-1}, &pool);  // 无法回收，直接销毁
+        const auto& stats = pool.stats();
+        assert(stats.shared_returns == 1);
+        assert(stats.recycle_failures == 1);
+        assert(CountingIntDeleter::deleted == 1);
+        assert(IntPool::shared_size() == 1);
+    }
+    assert(PooledCursor::handles_stats().recycle_failures == 0);
+
+    fmt::println("✓ 游标句柄池测试通过");
+}
+
+void test_fast_cursor(::mdbx::env_managed& env) {
+    fmt::println("\n=== 测试 FastCursor ===");
+
+    MapConfig single_config{"find_batch_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+    MapConfig multi_config{"fast_cursor_multi_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::multi};
+
+    // 写入多值数据
+    {
+        RWTxnManaged txn(env);
+        FastCursorDupSort cursor{txn, multi_config};
+        for (const char* key : {"k1", "k2"}) {
+            for (const char* value : {"v1", "v2", "v3"}) {
+                cursor.upsert(str_to_slice(key), str_to_slice(value));
+            }
+        }
+        txn.commit_and_stop();
+    }
+
+    ROTxnManaged txn(env);
+
+    // 单值表：与 PooledCursor 结果一致
+    {
+        FastCursor<> fast{txn, single_config};
+        PooledCursor pooled{txn, single_config};
+        for (size_t i = 0; i < 20; ++i) {
+            std::string key = uint64_to_hex(i);
+            auto fast_result = fast.find(str_to_slice(key), false);
+            auto pooled_result = pooled.find(str_to_slice(key), false);
+            assert(fast_result == pooled_result);
+        }
+        auto lb = fast.lower_bound(str_to_slice(uint64_to_hex(1)), false);
+        assert(lb.done && lb.key.as_string() == uint64_to_hex(2));
+
+        // 未定位的游标从头开始遍历
+        FastCursor<> scan{txn, single_config};
+        size_t count = cursor_for_each(scan, [](ByteView, ByteView) {});
+        assert(count == 500);
+
+        // 移动后的游标可以继续使用
+        FastCursor<> moved{std::move(fast)};
+        auto first = moved.to_first(false);
+        assert(first.key.as_string() == uint64_to_hex(0));
+    }
+
+    // 多值表：多值导航和前缀遍历
+    {
+        FastCursorDupSort fast{txn, multi_config};
+        auto result = fast.find(str_to_slice("k1"), false);
+        assert(result.done && result.value.as_string() == "v1");
+        assert(fast.count_multivalue() == 3);
+        auto next_value = fast.to_current_next_multi(false);
+        assert(next_value.value.as_string() == "v2");
+        auto next_key = fast.to_next_first_multi(false);
+        assert(next_key.key.as_string() == "k2");
+        auto found_value = fast.find_multivalue(str_to_slice("k2"), str_to_slice("v3"), false);
+        assert(found_value.done);
+
+        std::string prefix = "k";
+        size_t count = cursor_for_prefix(fast, str_to_byteview(prefix), [](ByteView, ByteView) {});
+        assert(count == 6);
+    }
+
+    // 值模式不匹配时抛出异常
+    bool thrown = false;
+    try {
+        FastCursor<> wrong{txn, multi_config};
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    txn.abort();
+    fmt::println("✓ FastCursor 测试通过");
+}
+
+void test_parallel_for_each(::mdbx::env_managed& env) {
+    fmt::println("\n=== 测试并行遍历 parallel_for_each ===");
+
+    MapConfig config{"find_batch_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+
+    for (size_t threads : {1, 4, 16}) {
+        ROTxnManaged txn(env);
+        std::vector<std::atomic<int>> seen(1000);
+        size_t count = parallel_for_each(txn, config, [&](ByteView key, ByteView value) {
+            std::string key_str = byteview_to_str(key);
+            assert(byteview_to_str(value) == "value_" + key_str);
+            seen[hex_to_uint64(key_str)]++;
+        }, threads);
+        fmt::println("线程数 {}: 遍历 {} 条记录", threads, count);
+        assert(count == 500);
+        for (size_t i = 0; i < seen.size(); ++i) {
+            assert(seen[i] == (i % 2 == 0 ? 1 : 0));
+        }
+        txn.abort();
+    }
+
+    // 写事务中的未提交数据也必须被遍历到（由调用线程完成）
+    {
+        RWTxnManaged txn(env);
+        txn.disable_commit();
+        auto cursor = txn.rw_cursor(config);
+        cursor->upsert(str_to_slice(uint64_to_hex(1)), str_to_slice("value_" + uint64_to_hex(1)));
+        std::atomic<size_t> walked{0};
+        size_t count = parallel_for_each(txn, config, [&](ByteView, ByteView) { walked++; }, 4);
+        assert(count == 501 && walked == 501);
+        txn.abort();
+    }
+
+    // 遍历函数抛出的异常被传递给调用者
+    {
+        ROTxnManaged txn(env);
+        bool thrown = false;
+        try {
+            parallel_for_each(txn, config, [](ByteView, ByteView) { throw std::runtime_error("stop"); }, 4);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        txn.abort();
+    }
+
+    fmt::println("✓ 并行遍历测试通过");
+}
+
+void test_cursor_for_each_block(::mdbx::env_managed& env) {
+    fmt::println("\n=== 测试分块遍历 cursor_for_each_block ===");
+
+    std::vector<ByteView> keys(64);
+    std::vector<ByteView> values(64);
+
+    // 单值表：按块回调，最后一块不满
+    {
+        MapConfig config{"find_batch_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+        ROTxnManaged txn(env);
+        std::vector<size_t> block_sizes;
+        std::string previous;
+        size_t count = cursor_for_each_block(txn, config, keys, values,
+            [&](std::span<const ByteView> block_keys, std::span<const ByteView> block_values) {
+                assert(block_keys.size() == block_values.size());
+                block_sizes.push_back(block_keys.size());
+                for (size_t i = 0; i < block_keys.size(); ++i) {
+                    std::string key = byteview_to_str(block_keys[i]);
+                    assert(key > previous);
+                    assert(byteview_to_str(block_values[i]) == "value_" + key);
+                    previous = key;
+                }
+            });
+        assert(count == 500);
+        assert(block_sizes.size() == 8 && block_sizes.back() == 500 - 7 * 64);
+        txn.abort();
+    }
+
+    // 定长多值表：使用 MDBX_GET_MULTIPLE 批量读取
+    {
+        MapConfig config{"block_fixed_multi_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::multi_samelength};
+        {
+            RWTxnManaged txn(env);
+            auto cursor = txn.rw_cursor_dup_sort(config);
+            for (uint64_t k = 0; k < 3; ++k) {
+                for (uint64_t v = 0; v < 1000; ++v) {
+                    std::string key = uint64_to_hex(k);
+                    std::string value = uint64_to_hex(k * 1000 + v);
+                    cursor->upsert(str_to_slice(key), str_to_slice(value));
+                }
+            }
+            txn.commit_and_stop();
+        }
+
+        ROTxnManaged txn(env);
+        uint64_t expected = 0;
+        size_t count = cursor_for_each_block(txn, config, keys, values,
+            [&](std::span<const ByteView> block_keys, std::span<const ByteView> block_values) {
+                for (size_t i = 0; i < block_keys.size(); ++i, ++expected) {
+                    assert(hex_to_uint64(byteview_to_str(block_keys[i])) == expected / 1000);
+                    assert(hex_to_uint64(byteview_to_str(block_values[i])) == expected);
+                }
+            });
+        assert(count == 3000 && expected == 3000);
+        txn.abort();
+    }
+
+    // 缓冲区大小不一致时抛出异常
+    bool thrown = false;
+    try {
+        ROTxnManaged txn(env);
+        MapConfig config{"find_batch_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+        cursor_for_each_block(txn, config, std::span<ByteView>{keys}, std::span<ByteView>{values}.first(10),
+                              [](std::span<const ByteView>, std::span<const ByteView>) {});
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    fmt::println("✓ 分块遍历测试通过");
+}
+
+void test_custom_key_comparator(::mdbx::env_managed& env) {
+    fmt::println("\n=== 测试复合键自定义比较器 ===");
+
+    // 20字节地址 + 大端区块号
+    auto make_key = [](uint8_t account, uint64_t block) {
+        std::string key(20, '\0');
+        key[0] = static_cast<char>(0x80 | account);  // 高位字节覆盖有符号比较的情况
+        key[19] = static_cast<char>(account);
+        for (int i = 0; i < 8; ++i) {
+            key.push_back(static_cast<char>(block >> (56 - 8 * i)));
+        }
+        return key;
+    };
+
+    // 比较结果与 memcmp 顺序一致，包括长度不符合布局的键
+    std::vector<std::string> samples{make_key(1, 5), make_key(1, 300), make_key(2, 0), make_key(0, UINT64_MAX),
+                                     make_key(1, 5).substr(0, 20), std::string(20, '\xff'), std::string{}};
+    for (const auto& lhs : samples) {
+        for (const auto& rhs : samples) {
+            MDBX_val a{const_cast<char*>(lhs.data()), lhs.size()};
+            MDBX_val b{const_cast<char*>(rhs.data()), rhs.size()};
+            const int expected = lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+            assert(compare_address20_block_keys(&a, &b) == expected);
+        }
+    }
+
+    MapConfig config{"address_block_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single,
+                     compare_address20_block_keys};
+    {
+        RWTxnManaged txn(env);
+        auto cursor = txn.rw_cursor(config);
+        for (uint8_t account = 0; account < 4; ++account) {
+            for (uint64_t block : {uint64_t{700}, uint64_t{3}, uint64_t{256}, uint64_t{1} << 40}) {
+                cursor->upsert(str_to_slice(make_key(account, block)), str_to_slice(std::to_string(block)));
+            }
+        }
+        txn.commit_and_stop();
+    }
+
+    // 顺序遍历与字节序一致，地址前缀查找仍然可用
+    {
+        ROTxnManaged txn(env);
+        auto cursor = txn.ro_cursor(config);
+        std::string previous;
+        size_t count = 0;
+        cursor_for_each(*cursor, [&](ByteView key, ByteView) {
+            std::string current = byteview_to_str(key);
+            assert(current > previous);
+            previous = current;
+            ++count;
+        });
+        assert(count == 16);
+
+        std::string account_prefix = make_key(2, 0).substr(0, 20);
+        std::vector<std::string> blocks;
+        cursor_for_prefix(*cursor, str_to_byteview(account_prefix),
+                          [&](ByteView, ByteView value) { blocks.push_back(byteview_to_str(value)); });
+        assert((blocks == std::vector<std::string>{"3", "256", "700", std::to_string(uint64_t{1} << 40)}));
+
+        auto found = cursor->lower_bound(str_to_slice(make_key(2, 257)), false);
+        assert(found && found.value.as_string() == "700");
+
+        // 自定义比较器的表不按字节序切分，由调用线程按键序完整遍历一次
+        std::vector<std::string> walked;
+        const size_t walked_count = parallel_for_each(
+            txn, config, [&](ByteView key, ByteView) { walked.push_back(byteview_to_str(key)); }, 4);
+        assert(walked_count == 16 && walked.size() == 16);
+        assert(std::is_sorted(walked.begin(), walked.end()));
+        txn.abort();
+    }
+
+    fmt::println("✓ 复合键自定义比较器测试通过");
+}
+
+void test_history_pruner(::mdbx::env_managed& env) {
+    fmt::println("\n=== 测试历史版本裁剪 HistoryPruner ===");
+
+    // 账户名 + 大端区块号
+    auto make_key = [](const std::string& account, uint64_t block) {
+        std::string key = account;
+        for (int i = 0; i < 8; ++i) {
+            key.push_back(static_cast<char>(block >> (56 - 8 * i)));
+        }
+        return key;
+    };
+    auto remaining_blocks = [&](const MapConfig& config, const std::string& account) {
+        ROTxnManaged txn(env);
+        auto cursor = txn.ro_cursor(config);
+        std::vector<uint64_t> blocks;
+        cursor_for_prefix(*cursor, str_to_byteview(account), [&](ByteView key, ByteView) {
+            blocks.push_back(BlockBE64::decode(key.last<8>().data()));
+        });
+        return blocks;
+    };
+    auto read_checkpoint = [&](const std::string& map_name) -> std::optional<std::string> {
+        ROTxnManaged txn(env);
+        auto checkpoints = txn.ro_cursor(kPruneCheckpointsMap);
+        const auto found = checkpoints->find(str_to_slice(map_name), false);
+        if (!found) {
+            return std::nullopt;
+        }
+        return std::string{found.value.as_string()};
+    };
+
+    MapConfig config{"prune_history_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+    {
+        RWTxnManaged txn(env);
+        auto cursor = txn.rw_cursor(config);
+        for (const std::string account : {"acct_a", "acct_b"}) {
+            for (uint64_t block : {1, 5, 10, 20, 30}) {
+                cursor->upsert(str_to_slice(make_key(account, block)), str_to_slice(std::to_string(block)));
+            }
+        }
+        cursor->upsert(str_to_slice("x"), str_to_slice("短键不参与裁剪"));
+        txn.commit_and_stop();
+    }
+
+    // 单步裁剪：每个账户只保留 <= horizon 的最新版本及之后的所有版本
+    {
+        RWTxnManaged txn(env);
+        auto step = prune_history_step(txn, config, 12, {}, 1000, 1000);
+        assert(step.erased == 4);
+        assert(step.scanned == 11);
+        assert(!step.resume_key);
+        txn.commit_and_stop();
+    }
+    auto blocks_a = remaining_blocks(config, "acct_a");
+    auto blocks_b = remaining_blocks(config, "acct_b");
+    assert((blocks_a == std::vector<uint64_t>{10, 20, 30}));
+    assert((blocks_b == std::vector<uint64_t>{10, 20, 30}));
+
+    // 后台裁剪：极小的事务预算迫使多次提交并经由检查点续传
+    PruneConfig prune_config;
+    prune_config.retention_blocks = 15;
+    prune_config.max_erased_per_txn = 1;
+    prune_config.max_scanned_per_txn = 2;
+    prune_config.erase_rate = 0;
+    HistoryPruner pruner{env, config, prune_config};
+    pruner.start(40);
+    pruner.wait();
+
+    auto progress = pruner.progress();
+    fmt::println("裁剪完成: horizon {}, 扫描 {} 条, 删除 {} 条, 提交 {} 次",
+                 progress.horizon, progress.scanned, progress.erased, progress.commits);
+    assert(progress.phase == PrunePhase::kDone);
+    assert(!progress.stopped && !progress.failed);
+    assert(progress.horizon == 25);
+    assert(progress.erased == 2);
+    assert(progress.commits > 2);
+    blocks_a = remaining_blocks(config, "acct_a");
+    blocks_b = remaining_blocks(config, "acct_b");
+    assert((blocks_a == std::vector<uint64_t>{20, 30}));
+    assert((blocks_b == std::vector<uint64_t>{20, 30}));
+
+    // 完整的一轮结束后检查点被清除
+    assert(!read_checkpoint("prune_history_table"));
+    {
+        ROTxnManaged txn(env);
+        auto cursor = txn.ro_cursor(config);
+        const auto short_key = cursor->find(str_to_slice("x"), false);
+        assert(short_key);
+    }
+
+    // 中途停止后再次 start()：从检查点中的续传键继续，且不多删
+    MapConfig resume_config{"prune_resume_table", ::mdbx::key_mode::usual, ::mdbx::value_mode::single};
+    const std::vector<std::string> accounts{"acct_a", "acct_b", "acct_c", "acct_d"};
+    {
+        RWTxnManaged txn(env);
+        auto cursor = txn.rw_cursor(resume_config);
+        for (const auto& account : accounts) {
+            for (uint64_t block : {1, 5, 10, 20, 30}) {
+                cursor->upsert(str_to_slice(make_key(account, block)), str_to_slice(std::to_string(block)));
+            }
+        }
+        txn.commit_and_stop();
+    }
+
+    // 每删除一条限速等待 100ms，在第一次等待期间停止
+    prune_config.erase_rate = 10;
+    HistoryPruner resumable{env, resume_config, prune_config};
+    resumable.start(40);
+    while (resumable.progress().erased == 0 && resumable.progress().phase != PrunePhase::kDone) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    resumable.stop();
+    const auto first_pass = resumable.progress();
+    assert(first_pass.stopped && !first_pass.failed);
+    assert(first_pass.erased == 1);
+
+    // 停止前已越过的位置插入一个可被裁剪的旧版本：续传时不会再访问到它，从头开始则会删掉它
+    const auto resume_key = read_checkpoint("prune_resume_table");
+    const auto skipped_key = make_key("acct_a", 2);
+    assert(resume_key && *resume_key > skipped_key);
+    {
+        RWTxnManaged txn(env);
+        auto cursor = txn.rw_cursor(resume_config);
+        cursor->upsert(str_to_slice(skipped_key), str_to_slice("2"));
+        txn.commit_and_stop();
+    }
+
+    resumable.start(40);
+    resumable.wait();
+    const auto second_pass = resumable.progress();
+    fmt::println("续传裁剪: 第一轮删除 {} 条后停止, 第二轮扫描 {} 条, 删除 {} 条",
+                 first_pass.erased, second_pass.scanned, second_pass.erased);
+    assert(!second_pass.stopped && !second_pass.failed);
+    assert(first_pass.erased + second_pass.erased == 3 * accounts.size());
+    for (const auto& account : accounts) {
+        const auto blocks = remaining_blocks(resume_config, account);
+        if (account == "acct_a") {
+            assert((blocks == std::vector<uint64_t>{2, 20, 30}));
+        } else {
+            assert((blocks == std::vector<uint64_t>{20, 30}));
+        }
+    }
+    assert(!read_checkpoint("prune_resume_table"));
+
+    fmt::println("✓ 历史版本裁剪测试通过");
+}
+
+void test_metrics(::mdbx::env_managed& env) {
+    fmt::println("\n=== 测试指标注册表 ===");
+
+    auto& registry = MetricsRegistry::instance();
+    auto& commits = registry.counter("mdbx_txn_commits_total", "", "");
+    const uint64_t commits_before = commits.value();
+
+    // 未启用时不记录
+    {
+        RWTxnManaged txn(env);
+        txn.commit_and_stop();
+    }
+    assert(commits.value() == commits_before);
+
+    enable_metrics(1);
+    {
+        RWTxnManaged txn(env);
+        txn.commit_and_renew();
+        txn.commit_and_stop();
+    }
+    assert(commits.value() == commits_before + 2);
+
+    // 超过分片数的线程共享最后一个分片，计数不丢失
+    auto& counter = registry.counter("test_ops_total", "op=\"test\"", "Test counter");
+    auto& histogram = registry.histogram("test_op_duration_seconds", "", "Test histogram");
+    {
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < 2 * metrics_detail::kMetricShards; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 1000; ++i) {
+                    counter.add();
+                    histogram.observe(1000);
+                }
+            });
+        }
+    }
+    assert(counter.value() == 2 * metrics_detail::kMetricShards * 1000);
+    const auto snapshot = histogram.snapshot();
+    assert(snapshot.count == 2 * metrics_detail::kMetricShards * 1000);
+    assert(snapshot.buckets[10] == snapshot.count);  // 1000ns < 2^10ns
+    disable_metrics();
+
+    const std::string dump = registry.dump();
+    assert(dump.find("# TYPE mdbx_txn_commits_total counter") != std::string::npos);
+    assert(dump.find(fmt::format("test_ops_total{{op=\"test\"}} {}", counter.value())) != std::string::npos);
+    assert(dump.find("test_op_duration_seconds_bucket{le=\"+Inf\"}") != std::string::npos);
+    assert(dump.find("mdbx_txn_duration_seconds_count") != std::string::npos);
+    fmt::println("指标输出 {} 字节", dump.size());
+
+    fmt::println("✓ 指标注册表测试通过");
+}
+
 void test_error_handling_and_edge_cases(::mdbx::env_managed& env) {
     fmt::println("\n=== 测试错误处理和边界情况 ===");
 
@@ -833,6 +1565,36 @@ int main() {
         // 测试10: 错误处理和边界情况
         test_error_handling_and_edge_cases(env);
 
+        // 测试11: 批量查找
+        test_find_batch(env);
+
+        // 测试12: 页面预热
+        test_page_warmer(env, test_config);
+
+        // 测试13: 访问热力图
+        test_access_heatmap(env, test_config);
+
+        // 测试14: 游标句柄池
+        test_cursor_handle_pool(env);
+
+        // 测试15: FastCursor
+        test_fast_cursor(env);
+
+        // 测试16: 并行遍历
+        test_parallel_for_each(env);
+
+        // 测试17: 分块遍历
+        test_cursor_for_each_block(env);
+
+        // 测试18: 复合键自定义比较器
+        test_custom_key_comparator(env);
+
+        // 测试19: 历史版本裁剪
+        test_history_pruner(env);
+
+        // 测试20: 指标注册表
+        test_metrics(env);
+
         fmt::println("\n🎉 所有测试通过！MDBX包装API功能完整且正确工作。");
 
     } catch (const std::exception& e) {
@@ -1,8 +1,12 @@
 #include "core/query_engine.hpp"
 #include "db/rocksdb_impl.hpp"
+#include "db/rocksdb_iterator_pool.hpp"
+#include "utils/composite_key.hpp"
 
 #include <fmt/core.h>
+#include <chrono>
 #include <filesystem>
+#include <thread>
 
 int main() {
     const std::filesystem::path db_path = std::filesystem::temp_directory_path() / "rocksdb_test_db";
@@ -29,13 +33,186 @@ int main() {
         result = engine.find_account_state("alice", 0);
         fmt::print("Query alice at block 0: {}\n", result ? *result : "Not found");
 
-        fmt::print("RocksDB test passed!\n");
-        
+        fmt::print("Testing block import...\n");
+        const AccountStateChange block_20[] = {
+            {"alice", R"({"balance": "300"})"},
+            {"bob", R"({"balance": "50"})"},
+        };
+        engine.import_block(20, block_20, Durability::kSync);
+
+        result = engine.find_account_state("alice", 25);
+        fmt::print("Query alice at block 25: {}\n", result ? *result : "Not found");
+        if (!result || *result != R"({"balance": "300"})") {
+            fmt::print("Block import failed for alice\n");
+            return 1;
+        }
+
+        result = engine.find_account_state("bob", 19);
+        fmt::print("Query bob at block 19: {}\n", result ? *result : "Not found");
+        if (result) {
+            fmt::print("Block import leaked bob before block 20\n");
+            return 1;
+        }
+
+        // With the account prefix extractor, an account name prefixing another one must not see its versions
+        fmt::print("Testing account prefix seeks...\n");
+        engine.set_account_state("ali", 3, R"({"balance": "7"})");
+        result = engine.find_account_state("ali", 25);
+        fmt::print("Query ali at block 25: {}\n", result ? *result : "Not found");
+        if (!result || *result != R"({"balance": "7"})") {
+            fmt::print("Prefix seek returned a version of another account\n");
+            return 1;
+        }
+        result = engine.find_account_state("alic", 25);
+        if (result) {
+            fmt::print("Prefix seek found a version of a missing account\n");
+            return 1;
+        }
+
+        // Account names longer than a CompositeKey cannot be stored: reads miss, writes throw
+        fmt::print("Testing over-long account names...\n");
+        const std::string long_name(utils::kMaxAccountNameLength + 1, 'a');
+        if (engine.find_account_state(long_name, 25)) {
+            fmt::print("Lookback found an over-long account name\n");
+            return 1;
+        }
+        bool rejected = false;
+        try {
+            engine.set_account_state(long_name, 25, R"({"balance": "1"})");
+        } catch (const std::length_error&) {
+            rejected = true;
+        }
+        if (!rejected) {
+            fmt::print("Over-long account name was written\n");
+            return 1;
+        }
+
+        fmt::print("Testing batched queries...\n");
+        const StateQuery queries[] = {{"bob", 25}, {"alice", 7}, {"carol", 25}, {"alice", 25}, {"ali", 2}};
+        const auto results = engine.find_account_states(queries);
+        if (results.size() != 5 || results[0] != R"({"balance": "50"})" || results[1] != R"({"balance": "200"})" ||
+            results[2] || results[3] != R"({"balance": "300"})" || results[4]) {
+            fmt::print("Batched queries differ from single queries\n");
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        fmt::print("Error: {}\n", e.what());
+        return 1;
+    }
+
+    // The latest_state column family layout, opened on the database written above: its latest versions are backfilled
+    try {
+        fmt::print("Testing latest state column family...\n");
+        RocksDBConfig config;
+        config.latest_state_cf = true;
+        QueryEngine engine(std::make_unique<RocksDbImpl>(db_path, config));
+
+        // Blocks imported out of order must not replace a newer latest version
+        engine.set_account_state("alice", 30, R"({"balance": "400"})");
+        engine.set_account_state("alice", 15, R"({"balance": "250"})");
+
+        const StateQuery queries[] = {{"alice", 40}, {"alice", 20}, {"alice", 12}, {"bob", 40}, {"carol", 40}};
+        const auto results = engine.find_account_states(queries);
+        if (results[0] != R"({"balance": "400"})" || results[1] != R"({"balance": "300"})" ||
+            results[2] != R"({"balance": "150"})" || results[3] != R"({"balance": "50"})" || results[4] ||
+            engine.find_account_state("bob", 40) != R"({"balance": "50"})") {
+            fmt::print("Latest state column family returned wrong versions\n");
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        fmt::print("Error: {}\n", e.what());
+        return 1;
+    }
+
+    bool rejected = false;
+    try {
+        RocksDbImpl reopened(db_path);
+    } catch (const std::exception&) {
+        rejected = true;
+    }
+    if (!rejected) {
+        fmt::print("Database with a latest_state column family opened without it\n");
+        return 1;
+    }
+
+    // Pooled lookback iterators: refreshed on every lookback with iterator_staleness_ms = 0, otherwise once the
+    // staleness window has passed, own writes included
+    const std::filesystem::path pool_path = std::filesystem::temp_directory_path() / "rocksdb_iterator_pool_test_db";
+    for (const uint32_t staleness_ms : {0u, 50u}) {
+        std::filesystem::remove_all(pool_path);
+        try {
+            fmt::print("Testing iterator pool with {} ms staleness...\n", staleness_ms);
+            RocksDBConfig config;
+            config.iterator_staleness_ms = staleness_ms;
+            QueryEngine engine(std::make_unique<RocksDbImpl>(pool_path, config));
+
+            engine.set_account_state("alice", 1, R"({"balance": "100"})");
+            auto result = engine.find_account_state("alice", 5);  // Leaves an iterator in the pool
+            if (!result || *result != R"({"balance": "100"})") {
+                fmt::print("Lookback before the second write returned a wrong version\n");
+                return 1;
+            }
+
+            engine.set_account_state("alice", 3, R"({"balance": "300"})");
+            if (staleness_ms > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{2 * staleness_ms});
+            }
+            result = engine.find_account_state("alice", 5);
+            fmt::print("Query alice at block 5: {}\n", result ? *result : "Not found");
+            if (!result || *result != R"({"balance": "300"})") {
+                fmt::print("Pooled iterator missed a write older than the staleness window\n");
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            fmt::print("Error: {}\n", e.what());
+            return 1;
+        }
+    }
+
+    // Iterators left idle by a burst of readers expire past iterator_max_age_ms even when one thread keeps reusing
+    // the most recently released one
+    std::filesystem::remove_all(pool_path);
+    try {
+        fmt::print("Testing iterator pool expiry...\n");
+        rocksdb::Options options;
+        options.create_if_missing = true;
+        rocksdb::DB* raw_db = nullptr;
+        const rocksdb::Status status = rocksdb::DB::Open(options, pool_path.string(), &raw_db);
+        if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+        }
+        const std::unique_ptr<rocksdb::DB> db(raw_db);
+
+        RocksDBConfig config;
+        config.iterator_max_age_ms = 50;
+        IteratorPool pool(config);
+        {
+            auto first = pool.acquire(*db, rocksdb::ReadOptions());
+            auto second = pool.acquire(*db, rocksdb::ReadOptions());
+            auto third = pool.acquire(*db, rocksdb::ReadOptions());
+        }
+        if (pool.idle_size() != 3) {
+            fmt::print("Released iterators were not kept idle: {}\n", pool.idle_size());
+            return 1;
+        }
+
+        const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds{3 * config.iterator_max_age_ms};
+        while (std::chrono::steady_clock::now() < until) {
+            auto lease = pool.acquire(*db, rocksdb::ReadOptions());
+            std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        }
+        fmt::print("Idle iterators after single-threaded reuse: {}\n", pool.idle_size());
+        if (pool.idle_size() != 1) {
+            fmt::print("Idle iterators past max age were kept\n");
+            return 1;
+        }
     } catch (const std::exception& e) {
         fmt::print("Error: {}\n", e.what());
         return 1;
     }
+    std::filesystem::remove_all(pool_path);
 
+    fmt::print("RocksDB test passed!\n");
     std::filesystem::remove_all(db_path);
     return 0;
 }
\ No newline at end of file